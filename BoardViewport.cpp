@@ -0,0 +1,166 @@
+#include "BoardViewport.h"
+
+#include "PixelFill.h"
+#include "Theme.h"
+
+void BoardViewport::fit(int areaX, int areaY, int areaW, int areaH, int minTile, int maxTile) {
+  int maxTileW = (areaW - 2 * MARGIN) / boardW;
+  int maxTileH = (areaH - 2 * MARGIN) / boardH;
+  tileSize = maxTileW;
+  if (maxTileH < tileSize) {
+    tileSize = maxTileH;
+  }
+  if (tileSize > maxTile) {
+    tileSize = maxTile;
+  }
+  if (tileSize < minTile) {
+    tileSize = minTile;
+  }
+
+  boardX0 = areaX + (areaW - pixelWidth()) / 2;
+  if (boardX0 < areaX + MARGIN) {
+    boardX0 = areaX + MARGIN;
+  }
+
+  int contentTop = areaY + MARGIN;
+  int contentH = areaH - 2 * MARGIN;
+  boardY0 = contentTop + (contentH - pixelHeight()) / 2;
+  if (boardY0 < contentTop) {
+    boardY0 = contentTop;
+  }
+}
+
+bool BoardViewport::inBounds(int x, int y) const {
+  return x >= 0 && x < boardW && y >= 0 && y < boardH;
+}
+
+int BoardViewport::pixelWidth() const {
+  return boardW * tileSize;
+}
+
+int BoardViewport::pixelHeight() const {
+  return boardH * tileSize;
+}
+
+void BoardViewport::boardRow(const uint16_t* colors, int y, int xs, int xe, uint16_t* row) const {
+  // The board sits inside a 1px frame with a 1px gap; everything else is background.
+  const int frameX = boardX0 - FRAME;
+  const int frameY = boardY0 - FRAME;
+  const int frameRight = frameX + pixelWidth() + 2 * FRAME;
+  const int frameBottom = frameY + pixelHeight() + 2 * FRAME;
+  const int boardRight = boardX0 + pixelWidth();
+
+  if (y < frameY || y >= frameBottom) {
+    PixelFill::fill(row, xe - xs, colors[Theme::BG]);
+    return;
+  }
+  if (y == frameY || y == frameBottom - 1) {
+    PixelFill::fillSpan(row, xs, xe, xs, frameX, colors[Theme::BG]);
+    PixelFill::fillSpan(row, xs, xe, frameX, frameRight, colors[Theme::PANEL_LINE]);
+    PixelFill::fillSpan(row, xs, xe, frameRight, xe, colors[Theme::BG]);
+    return;
+  }
+
+  PixelFill::fillSpan(row, xs, xe, xs, frameX, colors[Theme::BG]);
+  PixelFill::fillSpan(row, xs, xe, frameX, frameX + 1, colors[Theme::PANEL_LINE]);
+  PixelFill::fillSpan(row, xs, xe, frameX + 1, boardX0, colors[Theme::BG]);
+  if (y >= boardY0 && y < boardY0 + pixelHeight()) {
+    int cs = (xs > boardX0) ? xs : boardX0;
+    int ce = (xe < boardRight) ? xe : boardRight;
+    if (cs < ce) {
+      cellsRow(colors, y, cs, ce, row + (cs - xs));
+    }
+  } else {
+    PixelFill::fillSpan(row, xs, xe, boardX0, boardRight, colors[Theme::BG]);
+  }
+  PixelFill::fillSpan(row, xs, xe, boardRight, frameRight - 1, colors[Theme::BG]);
+  PixelFill::fillSpan(row, xs, xe, frameRight - 1, frameRight, colors[Theme::PANEL_LINE]);
+  PixelFill::fillSpan(row, xs, xe, frameRight, xe, colors[Theme::BG]);
+}
+
+void BoardViewport::cellsRow(const uint16_t* colors, int y, int xs, int xe, uint16_t* row) const {
+  const int ry = y - boardY0;
+  const int gy = ry / tileSize;
+  const int ly = ry - gy * tileSize;
+  for (int gx = (xs - boardX0) / tileSize; gx < boardW; gx++) {
+    int cellX0 = cellX(gx);
+    if (cellX0 >= xe) {
+      break;
+    }
+    int from = (cellX0 > xs) ? cellX0 : xs;
+    int to = (cellX0 + tileSize < xe) ? cellX0 + tileSize : xe;
+    cellRow(colors, board[gy][gx], gx, gy, ly, from - cellX0, to - cellX0, row + (from - xs));
+  }
+}
+
+void BoardViewport::cellRow(const uint16_t* colors,
+                            char cell,
+                            int gx,
+                            int gy,
+                            int ly,
+                            int lxs,
+                            int lxe,
+                            uint16_t* row) const {
+  // Every part of a cell row is a solid run, so palette colours are read once per run.
+  if (cell == '#') {
+    if (ly <= 1) {
+      PixelFill::fill(row, lxe - lxs, colors[Theme::WALL_HI]);
+      return;
+    }
+    uint16_t body = (ly >= tileSize - 2) ? colors[Theme::WALL_SH] : colors[Theme::WALL];
+    PixelFill::fillSpan(row, lxs, lxe, 0, 2, colors[Theme::WALL_HI]);
+    PixelFill::fillSpan(row, lxs, lxe, 2, tileSize - 2, body);
+    PixelFill::fillSpan(row, lxs, lxe, tileSize - 2, tileSize, colors[Theme::WALL_SH]);
+    return;
+  }
+
+  if (ly == 0) {
+    PixelFill::fill(row, lxe - lxs, colors[Theme::GRID]);
+    return;
+  }
+  PixelFill::fillSpan(row, lxs, lxe, 0, 1, colors[Theme::GRID]);
+  uint16_t floorColor = colors[(((gx + gy) & 1) == 0) ? Theme::FLOOR_A : Theme::FLOOR_B];
+  if (!SokobanRules::isTarget(cell)) {
+    PixelFill::fillSpan(row, lxs, lxe, 1, tileSize, floorColor);
+    return;
+  }
+  targetRow(colors, floorColor, ly, lxs, lxe, row);
+}
+
+void BoardViewport::targetRow(
+  const uint16_t* colors, uint16_t floorColor, int ly, int lxs, int lxe, uint16_t* row) const {
+  // Disc, inner disc and hole painted over each other as centred runs.
+  const int from = (lxs > 1) ? lxs : 1;
+  PixelFill::fillSpan(row, lxs, lxe, from, tileSize, floorColor);
+  const int outer = targetRing->outer[ly];
+  if (outer < 0) {
+    return;
+  }
+  const int c = tileSize / 2;
+  const int inner = targetRing->inner[ly];
+  const int hole = targetRing->hole[ly];
+  PixelFill::fillSpan(row, lxs, lxe, c - outer, c + outer + 1, colors[Theme::TARGET]);
+  PixelFill::fillSpan(row, lxs, lxe, c - inner, c + inner + 1, colors[Theme::TARGET_HI]);
+  PixelFill::fillSpan(row, lxs, lxe, c - hole, c + hole + 1, floorColor);
+}
+
+void BoardViewport::drawCellOutline(
+  int gx, int gy, uint16_t color, int x0, int y0, int w, int h, uint16_t* buf) const {
+  // Clip the pass to the cell; only its 2px border is painted.
+  int cx0 = cellX(gx);
+  int cy0 = cellY(gy);
+  int ys = (cy0 > y0) ? cy0 : y0;
+  int ye = (cy0 + tileSize < y0 + h) ? cy0 + tileSize : y0 + h;
+  int xs = (cx0 > x0) ? cx0 : x0;
+  int xe = (cx0 + tileSize < x0 + w) ? cx0 + tileSize : x0 + w;
+  for (int y = ys; y < ye; y++) {
+    int ly = y - cy0;
+    bool rowEdge = ly < 2 || ly >= tileSize - 2;
+    for (int x = xs; x < xe; x++) {
+      int lx = x - cx0;
+      if (rowEdge || lx < 2 || lx >= tileSize - 2) {
+        buf[(y - y0) * w + (x - x0)] = color;
+      }
+    }
+  }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+#include "TargetRing.h"
+
+// One board on screen: its cells, the tile size and where the cells sit, and the row renderers
+// that paint them inside a 1 px frame. The playfield shows one; a race shows one per player.
+// Plain data, so render views capture it by copy.
+struct BoardViewport {
+  // Gap between the edge of the area a board is fitted into and its cells; the frame and the
+  // 1 px gap inside it take the inner half.
+  static constexpr int MARGIN = 4;
+  static constexpr int FRAME = 2;
+
+  SokobanRules::Board board;
+  int boardW;
+  int boardH;
+  int tileSize;
+  int boardX0;
+  int boardY0;
+  // Marker spans for `tileSize`, owned by the game; target cells are drawn from these.
+  const TargetRing* targetRing;
+
+  // Largest tile in [minTile, maxTile] that fits the board into the area with `MARGIN` on
+  // every side, with the board centred in it. A board too large for `minTile` overflows to
+  // the right and bottom.
+  void fit(int areaX, int areaY, int areaW, int areaH, int minTile, int maxTile);
+  bool inBounds(int x, int y) const;
+  int pixelWidth() const;
+  int pixelHeight() const;
+  // Screen position of the left edge of column `gx` / the top edge of row `gy`.
+  int cellX(int gx) const {
+    return boardX0 + gx * tileSize;
+  }
+  int cellY(int gy) const {
+    return boardY0 + gy * tileSize;
+  }
+
+  // Fills pixels [xs, xe) of screen row `y` into `row`, which holds pixel `xs` at index 0:
+  // frame and cells where the row crosses them, background elsewhere. `colors` is the
+  // palette `Theme::Color` indices resolve through.
+  void boardRow(const uint16_t* colors, int y, int xs, int xe, uint16_t* row) const;
+  // Paints the 2 px border of cell (gx, gy) where it overlaps the w x h region at (x0, y0).
+  void drawCellOutline(
+    int gx, int gy, uint16_t color, int x0, int y0, int w, int h, uint16_t* buf) const;
+
+private:
+  void cellsRow(const uint16_t* colors, int y, int xs, int xe, uint16_t* row) const;
+  void cellRow(const uint16_t* colors,
+               char cell,
+               int gx,
+               int gy,
+               int ly,
+               int lxs,
+               int lxe,
+               uint16_t* row) const;
+  // Floor of a target cell with its ring from `targetRing`, from local column 1 on.
+  void targetRow(
+    const uint16_t* colors, uint16_t floorColor, int ly, int lxs, int lxe, uint16_t* row) const;
+};
@@ -0,0 +1,36 @@
+#include "ButtonSet.h"
+
+#include <Arduino.h>
+
+void ButtonSet::begin(const SGFHardware::HardwareProfile& profile) {
+  leftPin.attach(profile.input.left, true);
+  rightPin.attach(profile.input.right, true);
+  upPin.attach(profile.input.up, true);
+  downPin.attach(profile.input.down, true);
+  firePin.attach(profile.input.fire, true);
+  leftPin.begin(INPUT_PULLUP);
+  rightPin.begin(INPUT_PULLUP);
+  upPin.begin(INPUT_PULLUP);
+  downPin.begin(INPUT_PULLUP);
+  firePin.begin(INPUT_PULLUP);
+
+  leftPin.resetFromPin();
+  rightPin.resetFromPin();
+  upPin.resetFromPin();
+  downPin.resetFromPin();
+  firePin.resetFromPin();
+
+  left.reset(leftPin.pressed());
+  right.reset(rightPin.pressed());
+  up.reset(upPin.pressed());
+  down.reset(downPin.pressed());
+  fire.reset(firePin.pressed());
+}
+
+void ButtonSet::update() {
+  left.update(leftPin.update());
+  right.update(rightPin.update());
+  up.update(upPin.update());
+  down.update(downPin.update());
+  fire.update(firePin.update());
+}
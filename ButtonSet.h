@@ -0,0 +1,25 @@
+#pragma once
+
+#include "SGF/Actions.h"
+#include "SGF/HardwareProfile.h"
+#include "SGF/InputPin.h"
+
+// One player's five buttons: the debounced pins named by a `HardwareProfile`'s input wiring
+// and the actions the scenes read. The game keeps one set per player.
+struct ButtonSet {
+  DebouncedInputPin leftPin;
+  DebouncedInputPin rightPin;
+  DebouncedInputPin upPin;
+  DebouncedInputPin downPin;
+  DebouncedInputPin firePin;
+
+  DigitalAction left;
+  DigitalAction right;
+  DigitalAction up;
+  DigitalAction down;
+  DigitalAction fire;
+
+  // Attaches the pins with pull-ups and seeds the actions from their current state.
+  void begin(const SGFHardware::HardwareProfile& profile);
+  void update();
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// Dirty board cells as one bit per cell, flushed in chunks aligned to the board's cell grid.
+// A chunk is the widest block of whole cells that fits the region buffer, so every cell is
+// rendered exactly once per flush and never split across two pushes. Rect parts outside the
+// board are handed back to the caller for the screen-anchored flusher.
+class DirtyCellMap {
+public:
+  static_assert(SokobanRules::BOARD_MAX_W <= 16, "a board row must fit one uint16_t");
+
+  // Board origin, size in cells and cell size in pixels. A change drops every marked cell,
+  // since they no longer name the same pixels; the caller repaints the new layout.
+  void setBoard(int originX, int originY, int cols, int rows, int cellSize, int capacityPixels) {
+    if (originX == boardX0 && originY == boardY0 && cols == boardCols && rows == boardRows &&
+        cellSize == cell) {
+      return;
+    }
+    boardX0 = originX;
+    boardY0 = originY;
+    boardCols = cols;
+    boardRows = rows;
+    cell = cellSize;
+    const int cellsFit = (cell > 0) ? capacityPixels / (cell * cell) : 0;
+    chunkCols = (cellsFit < boardCols) ? cellsFit : boardCols;
+    chunkCols = (chunkCols < 1) ? 1 : chunkCols;
+    chunkRows = cellsFit / chunkCols;
+    chunkRows = (chunkRows < 1) ? 1 : ((chunkRows > boardRows) ? boardRows : chunkRows);
+    clear();
+  }
+
+  void clear() {
+    for (uint16_t& row : rowBits) {
+      row = 0;
+    }
+  }
+
+  void markAll() {
+    for (int y = 0; y < SokobanRules::BOARD_MAX_H; y++) {
+      rowBits[y] = (y < boardRows) ? (uint16_t)((1u << boardCols) - 1u) : 0;
+    }
+  }
+
+  // Marks the cells an inclusive rect touches and calls `outside(x0, y0, x1, y1)` for up to
+  // four inclusive strips of it that lie off the board.
+  template <class Outside>
+  void add(int x0, int y0, int x1, int y1, Outside&& outside) {
+    const int bx1 = boardX0 + boardCols * cell - 1;
+    const int by1 = boardY0 + boardRows * cell - 1;
+    if (cell <= 0 || x1 < boardX0 || y1 < boardY0 || x0 > bx1 || y0 > by1) {
+      outside(x0, y0, x1, y1);
+      return;
+    }
+    const int ix0 = (x0 > boardX0) ? x0 : boardX0;
+    const int iy0 = (y0 > boardY0) ? y0 : boardY0;
+    const int ix1 = (x1 < bx1) ? x1 : bx1;
+    const int iy1 = (y1 < by1) ? y1 : by1;
+    if (y0 < boardY0) {
+      outside(x0, y0, x1, boardY0 - 1);
+    }
+    if (y1 > by1) {
+      outside(x0, by1 + 1, x1, y1);
+    }
+    if (x0 < boardX0) {
+      outside(x0, iy0, boardX0 - 1, iy1);
+    }
+    if (x1 > bx1) {
+      outside(bx1 + 1, iy0, x1, iy1);
+    }
+    const int gx0 = (ix0 - boardX0) / cell;
+    const int gx1 = (ix1 - boardX0) / cell;
+    const uint16_t bits = (uint16_t)(((1u << (gx1 - gx0 + 1)) - 1u) << gx0);
+    for (int gy = (iy0 - boardY0) / cell; gy <= (iy1 - boardY0) / cell; gy++) {
+      rowBits[gy] |= bits;
+    }
+  }
+
+  bool empty() const {
+    for (uint16_t row : rowBits) {
+      if (row != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Calls `render(x, y, w, h)` once per chunk holding dirty cells, with the bounding box of
+  // those cells in pixels, then clears the map.
+  template <class Render>
+  void flush(Render&& render) {
+    for (int cy0 = 0; cy0 < boardRows; cy0 += chunkRows) {
+      const int cy1 = (cy0 + chunkRows < boardRows) ? cy0 + chunkRows : boardRows;
+      for (int cx0 = 0; cx0 < boardCols; cx0 += chunkCols) {
+        const uint16_t mask = (uint16_t)(((1u << chunkCols) - 1u) << cx0);
+        uint16_t cols = 0;
+        int gy0 = -1;
+        int gy1 = -1;
+        for (int gy = cy0; gy < cy1; gy++) {
+          if ((rowBits[gy] & mask) != 0) {
+            cols |= rowBits[gy] & mask;
+            gy0 = (gy0 < 0) ? gy : gy0;
+            gy1 = gy;
+          }
+        }
+        if (cols == 0) {
+          continue;
+        }
+        int gx0 = cx0;
+        while ((cols & (1u << gx0)) == 0) {
+          gx0++;
+        }
+        int gx1 = cx0 + chunkCols - 1;
+        while ((cols & (1u << gx1)) == 0) {
+          gx1--;
+        }
+        render(boardX0 + gx0 * cell, boardY0 + gy0 * cell, (gx1 - gx0 + 1) * cell,
+               (gy1 - gy0 + 1) * cell);
+      }
+    }
+    clear();
+  }
+
+private:
+  uint16_t rowBits[SokobanRules::BOARD_MAX_H]{};
+  int boardX0 = 0;
+  int boardY0 = 0;
+  int boardCols = 0;
+  int boardRows = 0;
+  int cell = 0;
+  int chunkCols = 1;
+  int chunkRows = 1;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed-capacity list of inclusive dirty rectangles that can be copied between cores. When
+// full, a new rect is folded into the last one, so the list may over-cover but never drops
+// an area. `markAll()` stands for the whole screen.
+template <int MAX_RECTS>
+class DirtyLog {
+public:
+  struct Rect {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+  };
+
+  void clear() {
+    rectCount = 0;
+    wholeScreen = false;
+  }
+
+  void markAll() {
+    wholeScreen = true;
+  }
+
+  void add(int x0, int y0, int x1, int y1) {
+    if (wholeScreen) {
+      return;
+    }
+    if (rectCount < MAX_RECTS) {
+      rects[rectCount++] = Rect{(int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1};
+      return;
+    }
+    Rect& last = rects[MAX_RECTS - 1];
+    last.x0 = (int16_t)(x0 < last.x0 ? x0 : last.x0);
+    last.y0 = (int16_t)(y0 < last.y0 ? y0 : last.y0);
+    last.x1 = (int16_t)(x1 > last.x1 ? x1 : last.x1);
+    last.y1 = (int16_t)(y1 > last.y1 ? y1 : last.y1);
+  }
+
+  void merge(const DirtyLog& other) {
+    if (other.wholeScreen) {
+      markAll();
+      return;
+    }
+    for (int i = 0; i < other.rectCount; i++) {
+      const Rect& r = other.rects[i];
+      add(r.x0, r.y0, r.x1, r.y1);
+    }
+  }
+
+  bool empty() const {
+    return rectCount == 0 && !wholeScreen;
+  }
+
+  bool all() const {
+    return wholeScreen;
+  }
+
+  int count() const {
+    return rectCount;
+  }
+
+  const Rect& rect(int index) const {
+    return rects[index];
+  }
+
+private:
+  Rect rects[MAX_RECTS]{};
+  uint8_t rectCount = 0;
+  bool wholeScreen = false;
+};
@@ -0,0 +1,82 @@
+#include "EepromProgressStorage.h"
+
+#include <Arduino.h>
+
+#if SOKOBAN_VOLATILE_PROGRESS
+#define SOKOBAN_HAS_EEPROM 0
+#elif __has_include(<EEPROM.h>)
+#include <EEPROM.h>
+#define SOKOBAN_HAS_EEPROM 1
+#else
+// Without a backend progress would silently never be saved; make that an explicit choice.
+#error "no EEPROM library on this core; build with -DSOKOBAN_VOLATILE_PROGRESS=1"
+#endif
+
+EepromProgressStorage::EepromProgressStorage(uint32_t sizeBytes) : regionSize(sizeBytes) {}
+
+bool EepromProgressStorage::begin() {
+#if SOKOBAN_HAS_EEPROM
+#if defined(ESP32) || defined(ESP8266)
+  ready = EEPROM.begin(regionSize);
+#else
+  if (regionSize > EEPROM.length()) {
+    regionSize = EEPROM.length();
+  }
+  ready = true;
+#endif
+#else
+  regionSize = 0;
+  ready = false;
+#endif
+  return ready;
+}
+
+uint32_t EepromProgressStorage::size() const {
+  return ready ? regionSize : 0;
+}
+
+bool EepromProgressStorage::read(uint32_t offset, void* dst, uint32_t len) {
+  if (!ready || offset + len > regionSize) {
+    return false;
+  }
+#if SOKOBAN_HAS_EEPROM
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = EEPROM.read((int)(offset + i));
+  }
+  return true;
+#else
+  (void)dst;
+  return false;
+#endif
+}
+
+bool EepromProgressStorage::write(uint32_t offset, const void* src, uint32_t len) {
+  if (!ready || offset + len > regionSize) {
+    return false;
+  }
+#if SOKOBAN_HAS_EEPROM
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  for (uint32_t i = 0; i < len; i++) {
+    // Skip bytes that already hold the value, saving erase cycles on real EEPROM.
+    if (EEPROM.read((int)(offset + i)) != in[i]) {
+      EEPROM.write((int)(offset + i), in[i]);
+    }
+  }
+  return true;
+#else
+  (void)src;
+  return false;
+#endif
+}
+
+bool EepromProgressStorage::commit() {
+  if (!ready) {
+    return false;
+  }
+#if SOKOBAN_HAS_EEPROM && (defined(ESP32) || defined(ESP8266))
+  return EEPROM.commit();
+#else
+  return true;
+#endif
+}
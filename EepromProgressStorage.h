@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "IProgressStorage.h"
+
+// Build with -DSOKOBAN_VOLATILE_PROGRESS=1 to run on a core without an EEPROM library; the
+// region then has size 0 and progress is kept for the session only. Without the flag such a
+// core fails the build.
+#ifndef SOKOBAN_VOLATILE_PROGRESS
+#define SOKOBAN_VOLATILE_PROGRESS 0
+#endif
+
+// `IProgressStorage` over the Arduino EEPROM API. ESP32 emulates it in flash behind
+// `EEPROM.begin()` / `EEPROM.commit()`; the UNO Q's core provides the classic byte API
+// (`EEPROM.length()`, writes land immediately), also backed by the MCU's flash.
+class EepromProgressStorage : public IProgressStorage {
+public:
+  static constexpr uint32_t DEFAULT_SIZE = 1024;
+
+  explicit EepromProgressStorage(uint32_t sizeBytes = DEFAULT_SIZE);
+
+  bool begin() override;
+  uint32_t size() const override;
+  bool read(uint32_t offset, void* dst, uint32_t len) override;
+  bool write(uint32_t offset, const void* src, uint32_t len) override;
+  bool commit() override;
+
+private:
+  uint32_t regionSize = 0;
+  bool ready = false;
+};
@@ -11,7 +11,7 @@ void GameOverScene::onEnter() {
 
 void GameOverScene::onPhysics(float delta) {
   (void)delta;
-  if (game.fireConfirm.update(game.fireAction)) {
+  if (game.fireConfirm.update(game.buttons.fire)) {
     game.sceneSwitcher.switchTo(game.titleScene);
     game.resetClock();
   }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// Byte-addressed persistent region used by `ProgressStore`. Writes may be buffered by the
+// backend until `commit()`.
+class IProgressStorage {
+public:
+  virtual ~IProgressStorage() = default;
+
+  virtual bool begin() = 0;
+  virtual uint32_t size() const = 0;
+  virtual bool read(uint32_t offset, void* dst, uint32_t len) = 0;
+  virtual bool write(uint32_t offset, const void* src, uint32_t len) = 0;
+  virtual bool commit() = 0;
+};
@@ -0,0 +1,59 @@
+#include "LatencyProbe.h"
+
+namespace {
+
+constexpr uint32_t FIRST_LIMIT_US = 1000u;
+
+}  // namespace
+
+bool LatencyProbe::record(uint32_t edgeUs, uint32_t nowUs) {
+  if (edgeUs == lastEdgeUs) {
+    return false;
+  }
+  lastEdgeUs = edgeUs;
+  const uint32_t us = nowUs - edgeUs;
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && us >= bucketLimitUs(bucket)) {
+    bucket++;
+  }
+  counts[bucket]++;
+  lowestUs = (sampleCount == 0 || us < lowestUs) ? us : lowestUs;
+  highestUs = (us > highestUs) ? us : highestUs;
+  sumUs += us;
+  sampleCount++;
+  return sampleCount % REPORT_EVERY == 0;
+}
+
+void LatencyProbe::clear() {
+  for (uint32_t& count : counts) {
+    count = 0;
+  }
+  sampleCount = 0;
+  lowestUs = 0;
+  highestUs = 0;
+  sumUs = 0;
+}
+
+uint32_t LatencyProbe::samples() const {
+  return sampleCount;
+}
+
+uint32_t LatencyProbe::minUs() const {
+  return lowestUs;
+}
+
+uint32_t LatencyProbe::maxUs() const {
+  return highestUs;
+}
+
+uint32_t LatencyProbe::meanUs() const {
+  return (sampleCount == 0) ? 0u : (uint32_t)(sumUs / sampleCount);
+}
+
+uint32_t LatencyProbe::bucketCount(int index) const {
+  return counts[index];
+}
+
+uint32_t LatencyProbe::bucketLimitUs(int index) {
+  return (index >= BUCKETS - 1) ? 0u : FIRST_LIMIT_US << index;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// Histogram of button-to-pixel latencies: from the input edge that caused a move to the end
+// of the flush that pushed the cells it dirtied. Buckets double in width from 1 ms; the last
+// one is open-ended. Platform-free so tools/latency_sim can use it too.
+class LatencyProbe {
+public:
+  static constexpr int BUCKETS = 8;
+  // A report is due every this many samples.
+  static constexpr uint16_t REPORT_EVERY = 32;
+
+  // Records `nowUs - edgeUs` once per edge; repeats of the last edge are ignored, so a frame
+  // flushed in several chunks counts only its first. Returns true when a report is due.
+  bool record(uint32_t edgeUs, uint32_t nowUs);
+  void clear();
+
+  uint32_t samples() const;
+  uint32_t minUs() const;
+  uint32_t maxUs() const;
+  uint32_t meanUs() const;
+  uint32_t bucketCount(int index) const;
+  // Exclusive upper bound of a bucket; 0 for the last, open-ended one.
+  static uint32_t bucketLimitUs(int index);
+
+private:
+  uint32_t counts[BUCKETS]{};
+  uint32_t sampleCount = 0;
+  uint32_t lowestUs = 0;
+  uint32_t highestUs = 0;
+  uint64_t sumUs = 0;
+  uint32_t lastEdgeUs = 0;
+};
@@ -0,0 +1,257 @@
+#include "LevelGenerator.h"
+
+#include <string.h>
+
+using namespace SokobanRules;
+
+namespace {
+
+constexpr int MIN_SIZE = 5;
+// Share of the interior carved into floor, in percent.
+constexpr int FLOOR_PERCENT = 55;
+// One reverse move in PULL_ODDS_OUT_OF pulls a box when one is behind the player.
+constexpr int PULL_ODDS = 3;
+constexpr int PULL_ODDS_OUT_OF = 4;
+// A pull that switches box or direction scores like this many plain pulls.
+constexpr int CHANGE_WEIGHT = 2;
+
+int clampInt(int v, int lo, int hi) {
+  return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+}  // namespace
+
+void LevelGenerator::begin(uint32_t seed, const Params& paramsIn) {
+  params = paramsIn;
+  params.width = (uint8_t)clampInt(params.width, MIN_SIZE, BOARD_MAX_W);
+  params.height = (uint8_t)clampInt(params.height, MIN_SIZE, BOARD_MAX_H);
+  params.boxes = (uint8_t)clampInt(params.boxes, 1, MAX_BOXES);
+  if (params.candidates == 0) {
+    params.candidates = 1;
+  }
+  // xorshift32 must not start at zero.
+  rng = (seed != 0) ? seed : 0x9E3779B9u;
+  candidatesLeft = params.candidates;
+  candidateOpen = false;
+  haveBest = false;
+  bestScore = 0;
+  bestPulls = 0;
+  bestW = 0;
+  bestH = 0;
+  memset(best, '#', sizeof(best));
+}
+
+bool LevelGenerator::step(int moves) {
+  while (moves > 0 && candidatesLeft > 0) {
+    if (!candidateOpen) {
+      buildRoom();
+      moves--;
+      continue;
+    }
+    if (movesLeft == 0) {
+      finishCandidate();
+      continue;
+    }
+    reverseMove();
+    movesLeft--;
+    moves--;
+  }
+  return done();
+}
+
+bool LevelGenerator::done() const {
+  return candidatesLeft == 0;
+}
+
+const Board& LevelGenerator::board() const {
+  return best;
+}
+
+int LevelGenerator::width() const {
+  return bestW;
+}
+
+int LevelGenerator::height() const {
+  return bestH;
+}
+
+uint16_t LevelGenerator::score() const {
+  return bestScore;
+}
+
+uint16_t LevelGenerator::pulls() const {
+  return bestPulls;
+}
+
+uint32_t LevelGenerator::nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+int LevelGenerator::randomBelow(int n) {
+  return (int)(nextRandom() % (uint32_t)n);
+}
+
+void LevelGenerator::buildRoom() {
+  // A random walk with occasional 2x2 stamps keeps the floor connected and leaves the
+  // outer ring as wall.
+  memset(work, '#', sizeof(work));
+  const int w = params.width;
+  const int h = params.height;
+  const int interior = (w - 2) * (h - 2);
+  const int floorGoal = interior * FLOOR_PERCENT / 100;
+  int x = 1 + randomBelow(w - 2);
+  int y = 1 + randomBelow(h - 2);
+  int carved = 0;
+  for (int i = 0; i < interior * 8 && carved < floorGoal; i++) {
+    int dir = randomBelow(DIR_COUNT);
+    x = clampInt(x + DIR_DX[dir], 1, w - 2);
+    y = clampInt(y + DIR_DY[dir], 1, h - 2);
+    bool stamp = randomBelow(3) == 0;
+    for (int sy = 0; sy < (stamp ? 2 : 1); sy++) {
+      for (int sx = 0; sx < (stamp ? 2 : 1); sx++) {
+        int cx = clampInt(x + sx, 1, w - 2);
+        int cy = clampInt(y + sy, 1, h - 2);
+        if (work[cy][cx] == '#') {
+          work[cy][cx] = ' ';
+          carved++;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < params.boxes; i++) {
+    int bx;
+    int by;
+    if (pickFloor(bx, by)) {
+      work[by][bx] = '*';
+    }
+  }
+  if (!pickFloor(playerX, playerY)) {
+    // No room left for the player: score the candidate as empty.
+    movesLeft = 0;
+    candidateOpen = true;
+    playerX = -1;
+    return;
+  }
+  work[playerY][playerX] = '@';
+
+  lastBoxX = -1;
+  lastBoxY = -1;
+  lastDir = -1;
+  candidatePulls = 0;
+  candidateChanges = 0;
+  movesLeft = params.reverseMoves;
+  candidateOpen = true;
+}
+
+bool LevelGenerator::pickFloor(int& x, int& y) {
+  const int w = params.width;
+  const int h = params.height;
+  for (int tries = 0; tries < 32; tries++) {
+    x = 1 + randomBelow(w - 2);
+    y = 1 + randomBelow(h - 2);
+    if (work[y][x] == ' ') {
+      return true;
+    }
+  }
+  for (y = 1; y < h - 1; y++) {
+    for (x = 1; x < w - 1; x++) {
+      if (work[y][x] == ' ') {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void LevelGenerator::reverseMove() {
+  int dir = randomBelow(DIR_COUNT);
+  int nx = playerX + DIR_DX[dir];
+  int ny = playerY + DIR_DY[dir];
+  if (!isFreeForPlayer(work[ny][nx])) {
+    return;
+  }
+
+  // The box behind the player follows it: the reverse of pushing it in `-dir`.
+  int bx = playerX - DIR_DX[dir];
+  int by = playerY - DIR_DY[dir];
+  bool pull = isBox(work[by][bx]) && randomBelow(PULL_ODDS_OUT_OF) < PULL_ODDS;
+
+  work[playerY][playerX] = withoutPlayer(work[playerY][playerX]);
+  if (pull) {
+    work[by][bx] = withoutBox(work[by][bx]);
+    work[playerY][playerX] = withBox(work[playerY][playerX]);
+    if (bx != lastBoxX || by != lastBoxY || dir != lastDir) {
+      candidateChanges++;
+    }
+    candidatePulls++;
+    lastBoxX = playerX;
+    lastBoxY = playerY;
+    lastDir = dir;
+  }
+  playerX = nx;
+  playerY = ny;
+  work[playerY][playerX] = withPlayer(work[playerY][playerX]);
+}
+
+void LevelGenerator::finishCandidate() {
+  candidateOpen = false;
+  candidatesLeft--;
+  if (playerX < 0) {
+    return;
+  }
+
+  int boxCount = 0;
+  int onTarget = 0;
+  for (int y = 0; y < params.height; y++) {
+    for (int x = 0; x < params.width; x++) {
+      if (isBox(work[y][x])) {
+        boxCount++;
+      }
+      if (work[y][x] == '*') {
+        onTarget++;
+      }
+    }
+  }
+  uint16_t score = 0;
+  if (onTarget < boxCount) {
+    // Boxes left on their targets make the level easier than its pull count suggests.
+    uint32_t raw = (uint32_t)candidatePulls + (uint32_t)candidateChanges * CHANGE_WEIGHT;
+    raw /= (uint32_t)(onTarget + 1);
+    score = (uint16_t)((raw > 0xFFFFu) ? 0xFFFFu : raw);
+  }
+  if (!haveBest || score > bestScore) {
+    keepCropped();
+    bestScore = score;
+    bestPulls = candidatePulls;
+    haveBest = true;
+  }
+}
+
+void LevelGenerator::keepCropped() {
+  // The walk rarely reaches every interior cell; dropping all-wall rows and columns lets
+  // the game pick a larger tile size.
+  int x0 = params.width;
+  int y0 = params.height;
+  int x1 = 0;
+  int y1 = 0;
+  for (int y = 0; y < params.height; y++) {
+    for (int x = 0; x < params.width; x++) {
+      if (work[y][x] != '#') {
+        x0 = (x < x0) ? x : x0;
+        y0 = (y < y0) ? y : y0;
+        x1 = (x > x1) ? x : x1;
+        y1 = (y > y1) ? y : y1;
+      }
+    }
+  }
+  memset(best, '#', sizeof(best));
+  bestW = (uint8_t)(x1 - x0 + 3);
+  bestH = (uint8_t)(y1 - y0 + 3);
+  for (int y = y0; y <= y1; y++) {
+    memcpy(&best[y - y0 + 1][1], &work[y][x0], (size_t)(x1 - x0 + 1));
+  }
+}
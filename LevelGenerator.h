@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// Procedural levels by reverse play: carve a room, put every box on a target, then let the
+// player walk and *pull* boxes at random. Every pull undoes a legal push, so the final
+// position is solvable by replaying the walk forwards. Each candidate room is scored by
+// pulls and by how often consecutive pulls switch box or direction; the best one is kept.
+//
+// Work is split into `step()` calls so the game can spread a generation over frames. All
+// state is fixed-size members.
+class LevelGenerator {
+public:
+  static constexpr int MAX_BOXES = 8;
+
+  struct Params {
+    uint8_t width = 10;
+    uint8_t height = 8;
+    uint8_t boxes = 3;
+    // Reverse moves (steps and pulls) per candidate room.
+    uint16_t reverseMoves = 400;
+    uint8_t candidates = 8;
+  };
+
+  // Starts a new generation; sizes are clamped to the board limits.
+  void begin(uint32_t seed, const Params& params);
+  // Runs up to `moves` reverse moves. Returns true once every candidate has been scored.
+  bool step(int moves);
+  bool done() const;
+
+  // Best level so far in XSB symbols, cropped to its walls; valid once `done()`.
+  const SokobanRules::Board& board() const;
+  int width() const;
+  int height() const;
+  uint16_t score() const;
+  uint16_t pulls() const;
+
+private:
+  SokobanRules::Board work{};
+  SokobanRules::Board best{};
+  Params params;
+  uint32_t rng = 1;
+  uint8_t candidatesLeft = 0;
+  uint16_t movesLeft = 0;
+  bool candidateOpen = false;
+  int playerX = 0;
+  int playerY = 0;
+  int lastBoxX = -1;
+  int lastBoxY = -1;
+  int lastDir = -1;
+  uint16_t candidatePulls = 0;
+  uint16_t candidateChanges = 0;
+  uint8_t bestW = 0;
+  uint8_t bestH = 0;
+  uint16_t bestScore = 0;
+  uint16_t bestPulls = 0;
+  bool haveBest = false;
+
+  uint32_t nextRandom();
+  int randomBelow(int n);
+  void buildRoom();
+  bool pickFloor(int& x, int& y);
+  void reverseMove();
+  void finishCandidate();
+  void keepCropped();
+};
@@ -0,0 +1,140 @@
+#include "LevelPack.h"
+
+#include <string.h>
+
+#include "Crc32.h"
+
+namespace LevelPack {
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+// LSB-first bit reader that never reads past `end`.
+class BitReader {
+public:
+  BitReader(const uint8_t* begin, const uint8_t* endIn) : next(begin), end(endIn) {}
+
+  bool read(int bits, uint8_t& value) {
+    while (count < bits) {
+      if (next == end) {
+        return false;
+      }
+      buffer |= (uint32_t)*next++ << count;
+      count += 8;
+    }
+    value = (uint8_t)(buffer & ((1u << bits) - 1u));
+    buffer >>= bits;
+    count -= bits;
+    return true;
+  }
+
+private:
+  const uint8_t* next;
+  const uint8_t* end;
+  uint32_t buffer = 0;
+  int count = 0;
+};
+
+}  // namespace
+
+bool verify(const uint8_t* pack, size_t packBytes) {
+  if (packBytes < (size_t)HEADER_BYTES || memcmp(pack, "SKP2", 4) != 0) {
+    return false;
+  }
+  size_t payload = readU16(pack + 6);
+  if ((size_t)HEADER_BYTES + payload != packBytes) {
+    return false;
+  }
+  if (crc32(pack + HEADER_BYTES, payload) != readU32(pack + 8)) {
+    return false;
+  }
+  int count = levelCount(pack);
+  if ((size_t)HEADER_BYTES + 2u * (size_t)count > packBytes) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    if ((size_t)readU16(pack + HEADER_BYTES + 2 * i) + LEVEL_HEADER_BYTES > packBytes) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int levelCount(const uint8_t* pack) {
+  return pack[COUNT_OFFSET];
+}
+
+bool par(const uint8_t* pack, size_t packBytes, int index, uint16_t& moves, uint16_t& pushes) {
+  if (index < 0 || index >= levelCount(pack)) {
+    return false;
+  }
+  size_t offset = readU16(pack + HEADER_BYTES + 2 * index);
+  if (offset + LEVEL_HEADER_BYTES > packBytes) {
+    return false;
+  }
+  moves = readU16(pack + offset + 2);
+  pushes = readU16(pack + offset + 4);
+  return true;
+}
+
+bool decode(const uint8_t* pack,
+            size_t packBytes,
+            int index,
+            SokobanRules::Board& board,
+            int& width,
+            int& height) {
+  if (index < 0 || index >= levelCount(pack)) {
+    return false;
+  }
+  size_t offset = readU16(pack + HEADER_BYTES + 2 * index);
+  if (offset + LEVEL_HEADER_BYTES > packBytes) {
+    return false;
+  }
+  width = pack[offset];
+  height = pack[offset + 1];
+  if (width <= 0 || width > SokobanRules::BOARD_MAX_W || height <= 0 ||
+      height > SokobanRules::BOARD_MAX_H) {
+    return false;
+  }
+
+  memset(board, ' ', sizeof(board));
+  BitReader bits(pack + offset + LEVEL_HEADER_BYTES, pack + packBytes);
+  const int total = width * height;
+  int cell = 0;
+  while (cell < total) {
+    uint8_t symbol;
+    if (!bits.read(SYMBOL_BITS, symbol)) {
+      return false;
+    }
+    char value;
+    int length = 1;
+    if (symbol == RUN_SYMBOL) {
+      uint8_t wall;
+      uint8_t extra;
+      if (!bits.read(1, wall) || !bits.read(RUN_LENGTH_BITS, extra)) {
+        return false;
+      }
+      value = wall ? '#' : ' ';
+      length = RUN_MIN + extra;
+    } else {
+      value = SYMBOL_CELLS[symbol];
+    }
+    if (cell + length > total) {
+      return false;
+    }
+    for (int i = 0; i < length; i++, cell++) {
+      board[cell / width][cell % width] = value;
+    }
+  }
+  return true;
+}
+
+}  // namespace LevelPack
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// Read-only level pack image, decoded straight from flash. Layout (little-endian):
+//
+//   0   "SKP2"
+//   4   uint8  level count
+//   5   uint8  reserved, 0
+//   6   uint16 payload bytes (everything after this 12-byte header)
+//   8   uint32 CRC-32 of the payload
+//   12  uint16 offset of each level from the start of the image
+//   ..  per level: uint8 width, uint8 height, uint16 par moves, uint16 par pushes (0 when
+//       unknown), then a cell bit stream
+//
+// Cells are row-major, LSB-first 3-bit symbols: 0 floor, 1 wall, 2 target, 3 box, 4 box on
+// target, 5 player, 6 player on target. Symbol 7 starts a run: 1 bit (0 floor, 1 wall) and
+// 4 bits of length - RUN_MIN. The offset table gives random access to any level; the CRC is
+// checked once by `verify()` rather than on every load. `tools/level_pack` writes images.
+namespace LevelPack {
+
+constexpr int HEADER_BYTES = 12;
+constexpr int COUNT_OFFSET = 4;
+constexpr int LEVEL_HEADER_BYTES = 6;
+constexpr int SYMBOL_BITS = 3;
+constexpr uint8_t RUN_SYMBOL = 7;
+constexpr int RUN_LENGTH_BITS = 4;
+constexpr int RUN_MIN = 3;
+constexpr int RUN_MAX = RUN_MIN + (1 << RUN_LENGTH_BITS) - 1;
+constexpr char SYMBOL_CELLS[RUN_SYMBOL] = {' ', '#', '.', '$', '*', '@', '+'};
+
+// Checks magic, sizes, CRC and that every offset lies inside the image.
+bool verify(const uint8_t* pack, size_t packBytes);
+
+int levelCount(const uint8_t* pack);
+
+// Move- and push-optimal solution lengths recorded by tools/par_solver; 0 when unknown.
+bool par(const uint8_t* pack, size_t packBytes, int index, uint16_t& moves, uint16_t& pushes);
+
+// Decodes level `index` into `board` (cells outside the level become floor). Returns false
+// for a bad index or a malformed level; `board` may then be partly written.
+bool decode(const uint8_t* pack,
+            size_t packBytes,
+            int index,
+            SokobanRules::Board& board,
+            int& width,
+            int& height);
+
+}  // namespace LevelPack
@@ -0,0 +1,271 @@
+#include "LevelSelectScene.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "SokobanGame.h"
+
+namespace {
+
+constexpr int TITLE_Y = 8;
+const char* const TITLE_TEXT = "WYBIERZ PLANSZE";
+const char* const HINT_TEXT = "STRZALKI - WYBOR   FIRE - GRAJ";
+#if SOKOBAN_RACE
+// Shown instead when a second set of buttons is wired.
+const char* const RACE_HINT_TEXT = "FIRE - GRAJ   FIRE 2 - WYSCIG";
+#endif
+// Replaces the hint when the level pack failed its CRC check and nothing can be played.
+const char* const BAD_PACK_TEXT = "BLAD PACZKI POZIOMOW";
+
+}  // namespace
+
+LevelSelectScene::LevelSelectScene(SokobanGame& gameRef) : game(gameRef) {}
+
+void LevelSelectScene::onEnter() {
+  game.waitForRenderIdle();
+  // The highlight frames may cross where the last board was; flush them as plain rects.
+  game.clearBoardGeometry();
+  game.screenshotSource = SokobanGame::ScreenshotSource::LevelSelect;
+  game.fireConfirm.reset();
+#if SOKOBAN_RACE
+  game.rivalFireConfirm.reset();
+#endif
+  updateLayout();
+  selected = game.progress.data().lastLevel;
+  if (selected >= SokobanGame::LEVEL_COUNT || !game.progress.isUnlocked(selected)) {
+    selected = 0;
+  }
+  buildPage((uint8_t)(selected - selected % PAGE_SIZE));
+}
+
+void LevelSelectScene::onPhysics(float delta) {
+  (void)delta;
+  // A bad pack leaves nothing to play; the page shows no thumbnails then.
+  if (game.fireConfirm.update(game.buttons.fire) && game.packValid) {
+    game.startNewGame(selected);
+    game.sceneSwitcher.switchTo(game.playingScene);
+    game.resetClock();
+    return;
+  }
+#if SOKOBAN_RACE
+  // The second player's FIRE starts a race on the selected level.
+  if (game.rivalInputSet && game.rivalFireConfirm.update(game.rivalButtons.fire) &&
+      game.raceScene.begin(selected)) {
+    game.sceneSwitcher.switchTo(game.raceScene);
+    game.resetClock();
+    return;
+  }
+#endif
+
+  if (game.buttons.left.justPressed()) {
+    select(selected - 1);
+  } else if (game.buttons.right.justPressed()) {
+    select(selected + 1);
+  } else if (game.buttons.up.justPressed()) {
+    select(selected - COLS);
+  } else if (game.buttons.down.justPressed()) {
+    select(selected + COLS);
+  }
+}
+
+void LevelSelectScene::onProcess(float delta) {
+  (void)delta;
+  game.flusher.flush(
+    game.flushTarget(), game.regionBuf, [this](int x0, int y0, int w, int h, uint16_t* buf) {
+      renderRegion(x0, y0, w, h, buf);
+    });
+  game.finishFlush();
+}
+
+void LevelSelectScene::updateLayout() {
+  const int screenW = game.renderTarget.width();
+  const int screenH = game.renderTarget.height();
+  cellW = (screenW - 8) / COLS;
+  cellH = (screenH - HEADER_H - FOOTER_H) / ROWS;
+  gridX0 = (screenW - cellW * COLS) / 2;
+  gridY0 = HEADER_H;
+  titleX = (screenW - Font5x7::textWidth(TITLE_TEXT, 2)) / 2;
+  hintText = HINT_TEXT;
+#if SOKOBAN_RACE
+  if (game.rivalInputSet) {
+    hintText = RACE_HINT_TEXT;
+  }
+#endif
+  if (!game.packValid) {
+    hintText = BAD_PACK_TEXT;
+  }
+  hintX = (screenW - Font5x7::textWidth(hintText, 1)) / 2;
+  hintY = screenH - FOOTER_H + 6;
+}
+
+void LevelSelectScene::buildPage(uint8_t firstLevel) {
+  // Thumbnails are rasterized once per page into 4-bit cell indices; drawing them later is a
+  // table lookup per pixel instead of re-reading the level rows.
+  pageStart = firstLevel;
+  memset(thumbCells, 0, sizeof(thumbCells));
+  const int innerW = cellW - 2 * (CELL_GAP + HIGHLIGHT_W) - 4;
+  const int innerH = cellH - 2 * (CELL_GAP + HIGHLIGHT_W) - 4 - LABEL_H;
+
+  for (int slot = 0; slot < PAGE_SIZE; slot++) {
+    int levelIndex = pageStart + slot;
+    labels[slot][0] = '\0';
+    thumbW[slot] = 0;
+    thumbH[slot] = 0;
+    thumbScale[slot] = 0;
+    if (levelIndex >= SokobanGame::LEVEL_COUNT) {
+      continue;
+    }
+
+    SokobanRules::Board cells;
+    int levelW = 0;
+    int levelH = 0;
+    if (!game.loadPackLevel((uint8_t)levelIndex, cells, levelW, levelH)) {
+      continue;
+    }
+    int scale = MAX_THUMB_SCALE;
+    while (scale > MIN_THUMB_SCALE && (levelW * scale > innerW || levelH * scale > innerH)) {
+      scale--;
+    }
+    thumbW[slot] = (uint8_t)levelW;
+    thumbH[slot] = (uint8_t)levelH;
+    thumbScale[slot] = (uint8_t)scale;
+    thumbX[slot] = (cellW - levelW * scale) / 2;
+    thumbY[slot] = CELL_GAP + HIGHLIGHT_W + 2 + (innerH - levelH * scale) / 2;
+    snprintf(labels[slot], sizeof(labels[slot]), "%u", (unsigned)(levelIndex + 1));
+
+    for (int y = 0; y < levelH; y++) {
+      for (int x = 0; x < levelW; x++) {
+        uint8_t index = THUMB_EMPTY;
+        switch (cells[y][x]) {
+          case '#': index = THUMB_WALL; break;
+          case ' ': index = THUMB_FLOOR; break;
+          case '.': index = THUMB_TARGET; break;
+          case '$': index = THUMB_BOX; break;
+          case '*': index = THUMB_BOX_ON_TARGET; break;
+          case '@':
+          case '+': index = THUMB_PLAYER; break;
+          default: break;
+        }
+        int cell = y * levelW + x;
+        thumbCells[slot][cell >> 1] |= (uint8_t)(index << ((cell & 1) * 4));
+      }
+    }
+  }
+
+  game.dirty.invalidate(game.renderTarget);
+}
+
+void LevelSelectScene::select(int levelIndex) {
+  if (levelIndex < 0 || levelIndex >= SokobanGame::LEVEL_COUNT || levelIndex == selected) {
+    return;
+  }
+  if (!game.progress.isUnlocked((uint8_t)levelIndex)) {
+    return;
+  }
+
+  uint8_t previous = selected;
+  selected = (uint8_t)levelIndex;
+  uint8_t page = (uint8_t)(selected - selected % PAGE_SIZE);
+  if (page != pageStart) {
+    buildPage(page);
+    return;
+  }
+  markHighlightDirty(previous - pageStart);
+  markHighlightDirty(selected - pageStart);
+}
+
+void LevelSelectScene::markHighlightDirty(int slot) {
+  // Only the highlight frame changes colour, so the thumbnail inside is never repainted.
+  int x = gridX0 + (slot % COLS) * cellW + CELL_GAP;
+  int y = gridY0 + (slot / COLS) * cellH + CELL_GAP;
+  int w = cellW - 2 * CELL_GAP;
+  int h = cellH - 2 * CELL_GAP;
+  game.markRectDirty(x, y, w, HIGHLIGHT_W);
+  game.markRectDirty(x, y + h - HIGHLIGHT_W, w, HIGHLIGHT_W);
+  game.markRectDirty(x, y + HIGHLIGHT_W, HIGHLIGHT_W, h - 2 * HIGHLIGHT_W);
+  game.markRectDirty(x + w - HIGHLIGHT_W, y + HIGHLIGHT_W, HIGHLIGHT_W, h - 2 * HIGHLIGHT_W);
+}
+
+Theme::Color LevelSelectScene::pixelAt(int x, int y) const {
+  if (Font5x7::textPixel(TITLE_TEXT, 2, x - titleX, y - TITLE_Y)) {
+    return Theme::ACCENT;
+  }
+  if (Font5x7::textPixel(hintText, 1, x - hintX, y - hintY)) {
+    return game.packValid ? Theme::TEXT_DIM : Theme::ACCENT;
+  }
+
+  int rx = x - gridX0;
+  int ry = y - gridY0;
+  if (rx < 0 || ry < 0 || rx >= cellW * COLS || ry >= cellH * ROWS) {
+    return Theme::BG;
+  }
+  int col = rx / cellW;
+  int row = ry / cellH;
+  return slotPixelAt(row * COLS + col, rx - col * cellW, ry - row * cellH);
+}
+
+Theme::Color LevelSelectScene::slotPixelAt(int slot, int lx, int ly) const {
+  if (pageStart + slot >= SokobanGame::LEVEL_COUNT) {
+    return Theme::BG;
+  }
+  if (lx < CELL_GAP || ly < CELL_GAP || lx >= cellW - CELL_GAP || ly >= cellH - CELL_GAP) {
+    return Theme::BG;
+  }
+  int edge = CELL_GAP + HIGHLIGHT_W;
+  if (lx < edge || ly < edge || lx >= cellW - edge || ly >= cellH - edge) {
+    return (pageStart + slot == selected) ? Theme::ACCENT : Theme::PANEL_LINE;
+  }
+
+  uint8_t levelIndex = (uint8_t)(pageStart + slot);
+  int labelX = (cellW - Font5x7::textWidth(labels[slot], 1)) / 2;
+  int labelY = cellH - edge - LABEL_H;
+  if (Font5x7::textPixel(labels[slot], 1, lx - labelX, ly - labelY)) {
+    if (!game.progress.isUnlocked(levelIndex)) {
+      return Theme::TEXT_DIM;
+    }
+    return game.progress.data().bestMoves[levelIndex] != 0 ? Theme::PLAYER_HI : Theme::TEXT;
+  }
+  if (!game.progress.isUnlocked(levelIndex)) {
+    return Theme::PANEL;
+  }
+
+  int scale = thumbScale[slot];
+  if (scale == 0) {
+    // No thumbnail was built for this slot (bad pack).
+    return Theme::PANEL;
+  }
+  int tx = lx - thumbX[slot];
+  int ty = ly - thumbY[slot];
+  if (tx < 0 || ty < 0) {
+    return Theme::PANEL;
+  }
+  int gx = tx / scale;
+  int gy = ty / scale;
+  if (gx >= thumbW[slot] || gy >= thumbH[slot]) {
+    return Theme::PANEL;
+  }
+
+  switch (thumbCell(slot, gx, gy)) {
+    case THUMB_WALL: return Theme::WALL;
+    case THUMB_FLOOR: return Theme::FLOOR_A;
+    case THUMB_TARGET: return Theme::TARGET;
+    case THUMB_BOX: return Theme::BOX;
+    case THUMB_BOX_ON_TARGET: return Theme::BOX_HI;
+    case THUMB_PLAYER: return Theme::PLAYER;
+    default: return Theme::PANEL;
+  }
+}
+
+uint8_t LevelSelectScene::thumbCell(int slot, int gx, int gy) const {
+  int cell = gy * thumbW[slot] + gx;
+  return (uint8_t)((thumbCells[slot][cell >> 1] >> ((cell & 1) * 4)) & 0x0F);
+}
+
+void LevelSelectScene::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+  const uint16_t* colors = game.themeColors;
+  for (int yy = 0; yy < h; yy++) {
+    for (int xx = 0; xx < w; xx++) {
+      buf[yy * w + xx] = colors[pixelAt(x0 + xx, y0 + yy)];
+    }
+  }
+}
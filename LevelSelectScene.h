@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SGF/Scene.h"
+#include "SokobanLevels.h"
+#include "SokobanRules.h"
+#include "Theme.h"
+
+class SokobanGame;
+
+class LevelSelectScene : public Scene {
+public:
+  explicit LevelSelectScene(SokobanGame& gameRef);
+
+  void onEnter() override;
+  void onPhysics(float delta) override;
+  void onProcess(float delta) override;
+
+  // Renders any screen region from the current page; used by flushes and screenshots.
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
+
+private:
+  static constexpr int COLS = 5;
+  static constexpr int ROWS = 2;
+  static constexpr int PAGE_SIZE = COLS * ROWS;
+  static constexpr int HEADER_H = 28;
+  static constexpr int FOOTER_H = 18;
+  static constexpr int CELL_GAP = 2;
+  static constexpr int HIGHLIGHT_W = 2;
+  static constexpr int LABEL_H = 10;
+  static constexpr int MIN_THUMB_SCALE = 2;
+  static constexpr int MAX_THUMB_SCALE = 4;
+  // Two 4-bit thumbnail indices per byte.
+  static constexpr int THUMB_BYTES = (SokobanRules::BOARD_MAX_CELLS + 1) / 2;
+
+  enum ThumbCell : uint8_t {
+    THUMB_EMPTY = 0,
+    THUMB_WALL,
+    THUMB_FLOOR,
+    THUMB_TARGET,
+    THUMB_BOX,
+    THUMB_BOX_ON_TARGET,
+    THUMB_PLAYER,
+  };
+
+  SokobanGame& game;
+  uint8_t selected = 0;
+  uint8_t pageStart = 0;
+  int gridX0 = 0;
+  int gridY0 = 0;
+  int cellW = 0;
+  int cellH = 0;
+  int titleX = 0;
+  const char* hintText = nullptr;
+  int hintX = 0;
+  int hintY = 0;
+  uint8_t thumbCells[PAGE_SIZE][THUMB_BYTES]{};
+  uint8_t thumbW[PAGE_SIZE]{};
+  uint8_t thumbH[PAGE_SIZE]{};
+  uint8_t thumbScale[PAGE_SIZE]{};
+  int thumbX[PAGE_SIZE]{};
+  int thumbY[PAGE_SIZE]{};
+  char labels[PAGE_SIZE][4]{};
+
+  void updateLayout();
+  void buildPage(uint8_t firstLevel);
+  void select(int levelIndex);
+  void markHighlightDirty(int slot);
+  Theme::Color pixelAt(int x, int y) const;
+  Theme::Color slotPixelAt(int slot, int lx, int ly) const;
+  uint8_t thumbCell(int slot, int gx, int gy) const;
+};
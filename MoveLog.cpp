@@ -0,0 +1,29 @@
+#include "MoveLog.h"
+
+void MoveLog::clear() {
+  count = 0;
+  overflow = false;
+}
+
+void MoveLog::append(SokobanRules::Dir dir) {
+  if (count >= MAX_MOVES) {
+    overflow = true;
+    return;
+  }
+  const int shift = (count & 3) * 2;
+  uint8_t& byte = packed[count >> 2];
+  byte = (uint8_t)((byte & ~(3u << shift)) | ((unsigned)dir << shift));
+  count++;
+}
+
+int MoveLog::length() const {
+  return count;
+}
+
+bool MoveLog::truncated() const {
+  return overflow;
+}
+
+SokobanRules::Dir MoveLog::move(int index) const {
+  return (SokobanRules::Dir)((packed[index >> 2] >> ((index & 3) * 2)) & 3u);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// The directions of one run, two bits per move. Moves past `MAX_MOVES` are dropped and mark
+// the log truncated, so a replay never claims to reach further than it does.
+class MoveLog {
+public:
+  static constexpr int MAX_MOVES = 512;
+
+  void clear();
+  void append(SokobanRules::Dir dir);
+  int length() const;
+  bool truncated() const;
+  SokobanRules::Dir move(int index) const;
+
+private:
+  uint8_t packed[MAX_MOVES / 4]{};
+  uint16_t count = 0;
+  bool overflow = false;
+};
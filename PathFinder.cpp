@@ -0,0 +1,108 @@
+#include "PathFinder.h"
+
+using namespace SokobanRules;
+
+int PathFinder::findPath(const Board& board,
+                         int boardW,
+                         int boardH,
+                         int fromX,
+                         int fromY,
+                         int toX,
+                         int toY) {
+  pathLength = 0;
+  if (toX < 0 || toX >= boardW || toY < 0 || toY >= boardH) {
+    return -1;
+  }
+  if (fromX == toX && fromY == toY) {
+    return 0;
+  }
+  if (!isFreeForPlayer(board[toY][toX])) {
+    return -1;
+  }
+
+  int stopIndex = toY * BOARD_MAX_W + toX;
+  if (!search(board, boardW, boardH, fromX, fromY, stopIndex)) {
+    return -1;
+  }
+
+  // Walk parents back from the target, then reverse into forward order.
+  int index = stopIndex;
+  int startIndex = fromY * BOARD_MAX_W + fromX;
+  while (index != startIndex && pathLength < MAX_PATH) {
+    uint8_t dir = parentDir[index];
+    path[pathLength++] = dir;
+    index -= DIR_DY[dir] * BOARD_MAX_W + DIR_DX[dir];
+  }
+  for (int i = 0, j = pathLength - 1; i < j; i++, j--) {
+    uint8_t tmp = path[i];
+    path[i] = path[j];
+    path[j] = tmp;
+  }
+  return pathLength;
+}
+
+void PathFinder::floodReachable(
+  const Board& board, int boardW, int boardH, int fromX, int fromY) {
+  pathLength = 0;
+  search(board, boardW, boardH, fromX, fromY, -1);
+}
+
+bool PathFinder::reachable(int x, int y) const {
+  return isVisited(x, y);
+}
+
+int PathFinder::length() const {
+  return pathLength;
+}
+
+Dir PathFinder::step(int index) const {
+  return static_cast<Dir>(path[index]);
+}
+
+bool PathFinder::search(const Board& board,
+                        int boardW,
+                        int boardH,
+                        int fromX,
+                        int fromY,
+                        int stopIndex) {
+  for (int y = 0; y < BOARD_MAX_H; y++) {
+    visited[y] = 0;
+  }
+
+  int head = 0;
+  int tail = 0;
+  queue[tail++] = (uint8_t)(fromY * BOARD_MAX_W + fromX);
+  markVisited(fromX, fromY);
+
+  while (head < tail) {
+    int index = queue[head++];
+    int x = index % BOARD_MAX_W;
+    int y = index / BOARD_MAX_W;
+    for (int dir = 0; dir < DIR_COUNT; dir++) {
+      int nx = x + DIR_DX[dir];
+      int ny = y + DIR_DY[dir];
+      if (nx < 0 || nx >= boardW || ny < 0 || ny >= boardH) {
+        continue;
+      }
+      if (isVisited(nx, ny) || !isFreeForPlayer(board[ny][nx])) {
+        continue;
+      }
+      int next = ny * BOARD_MAX_W + nx;
+      markVisited(nx, ny);
+      parentDir[next] = (uint8_t)dir;
+      if (next == stopIndex) {
+        return true;
+      }
+      queue[tail++] = (uint8_t)next;
+    }
+  }
+  return false;
+}
+
+bool PathFinder::isVisited(int x, int y) const {
+  return (visited[y] & (uint16_t)(1u << x)) != 0;
+}
+
+void PathFinder::markVisited(int x, int y) {
+  visited[y] |= (uint16_t)(1u << x);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// Breadth-first shortest walk over cells free for the player. All state is fixed-size:
+// a cell-index queue, one bitboard row per board row for the visited set and a parent
+// direction per cell, so a search never allocates.
+class PathFinder {
+public:
+  static constexpr int MAX_PATH = SokobanRules::BOARD_MAX_CELLS;
+
+  // Returns the number of steps from (fromX, fromY) to (toX, toY), 0 when they are the same
+  // cell, or -1 when the target is unreachable. The steps are available through `step()`.
+  int findPath(const SokobanRules::Board& board,
+               int boardW,
+               int boardH,
+               int fromX,
+               int fromY,
+               int toX,
+               int toY);
+
+  // Marks every cell the player can reach from (fromX, fromY) without pushing.
+  void floodReachable(
+    const SokobanRules::Board& board, int boardW, int boardH, int fromX, int fromY);
+  bool reachable(int x, int y) const;
+
+  int length() const;
+  SokobanRules::Dir step(int index) const;
+
+private:
+  static_assert(SokobanRules::BOARD_MAX_W <= 16, "visited rows are 16-bit bitboards");
+  static_assert(SokobanRules::BOARD_MAX_CELLS <= 256, "cell indices are stored as uint8_t");
+
+  uint8_t queue[SokobanRules::BOARD_MAX_CELLS]{};
+  uint8_t parentDir[SokobanRules::BOARD_MAX_CELLS]{};
+  uint16_t visited[SokobanRules::BOARD_MAX_H]{};
+  uint8_t path[MAX_PATH]{};
+  int pathLength = 0;
+
+  bool search(const SokobanRules::Board& board,
+              int boardW,
+              int boardH,
+              int fromX,
+              int fromY,
+              int stopIndex);
+  bool isVisited(int x, int y) const;
+  void markVisited(int x, int y);
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Solid-colour fills for RGB565 buffers that store several pixels per write: 8 with SSE2 or
+// NEON on hosts, 4 per 64-bit word on other 64-bit targets and 2 per 32-bit word everywhere
+// else (ESP32, UNO Q). The head is aligned first so every word store is naturally aligned.
+namespace PixelFill {
+
+#if defined(__GNUC__)
+typedef uint32_t __attribute__((may_alias)) Word32;
+typedef uint64_t __attribute__((may_alias)) Word64;
+#else
+typedef uint32_t Word32;
+typedef uint64_t Word64;
+#endif
+
+inline void fill(uint16_t* dst, int count, uint16_t color) {
+  if (count < 4) {
+    // Grid lines and wall edges: alignment work would cost more than it saves.
+    for (int i = 0; i < count; i++) {
+      dst[i] = color;
+    }
+    return;
+  }
+  if ((reinterpret_cast<uintptr_t>(dst) & 2u) != 0) {
+    *dst++ = color;
+    count--;
+  }
+
+  const uint32_t pair = (uint32_t)color | ((uint32_t)color << 16);
+#if defined(__SSE2__)
+  const __m128i lanes = _mm_set1_epi16((short)color);
+  while (count >= 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lanes);
+    dst += 8;
+    count -= 8;
+  }
+#elif defined(__ARM_NEON)
+  const uint16x8_t lanes = vdupq_n_u16(color);
+  while (count >= 8) {
+    vst1q_u16(dst, lanes);
+    dst += 8;
+    count -= 8;
+  }
+#elif UINTPTR_MAX > 0xFFFFFFFFu
+  if ((reinterpret_cast<uintptr_t>(dst) & 4u) != 0 && count >= 2) {
+    *reinterpret_cast<Word32*>(dst) = pair;
+    dst += 2;
+    count -= 2;
+  }
+  const uint64_t quad = (uint64_t)pair | ((uint64_t)pair << 32);
+  while (count >= 4) {
+    *reinterpret_cast<Word64*>(dst) = quad;
+    dst += 4;
+    count -= 4;
+  }
+#endif
+  while (count >= 2) {
+    *reinterpret_cast<Word32*>(dst) = pair;
+    dst += 2;
+    count -= 2;
+  }
+  if (count > 0) {
+    *dst = color;
+  }
+}
+
+// Fills the part of [from, to) that lies inside [xs, xe); `row` holds pixel `xs` at index 0.
+inline void fillSpan(uint16_t* row, int xs, int xe, int from, int to, uint16_t color) {
+  if (from < xs) {
+    from = xs;
+  }
+  if (to > xe) {
+    to = xe;
+  }
+  if (from < to) {
+    fill(row + (from - xs), to - from, color);
+  }
+}
+
+// One pixel at a time; kept as the baseline for `tools/pixel_fill_bench`.
+inline void fillScalar(uint16_t* dst, int count, uint16_t color) {
+  for (int i = 0; i < count; i++) {
+    dst[i] = color;
+  }
+}
+
+}  // namespace PixelFill
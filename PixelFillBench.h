@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "PixelFill.h"
+
+// Times `PixelFill::fill` against the one-pixel-per-store loop for the run lengths the
+// playfield renderer produces. Shared by `tools/pixel_fill_bench` on the host and the
+// SOKOBAN_RENDER_STATS boot report on the device; `nowUs` is the platform's clock.
+namespace PixelFillBench {
+
+// Single pixels (grid lines), wall edges, tile interiors, a region tile and a screen row.
+constexpr int RUN_LENGTHS[] = {1, 2, 15, 16, 20, 64, 240};
+constexpr int RUN_COUNT = sizeof(RUN_LENGTHS) / sizeof(RUN_LENGTHS[0]);
+
+struct Result {
+  int runLength;
+  uint32_t pixels;
+  uint32_t scalarUs;
+  uint32_t wordUs;
+};
+
+// Fills about `totalPixels` pixels of `buf` in runs of `runLength`, stepping the start by an
+// odd amount so both aligned and unaligned heads are covered. `capacity` must exceed
+// `runLength`.
+template <class NowUs>
+Result measure(uint16_t* buf, int capacity, int runLength, uint32_t totalPixels, NowUs nowUs) {
+  Result result{runLength, 0, 0, 0};
+  const uint32_t runs = totalPixels / (uint32_t)runLength;
+  result.pixels = runs * (uint32_t)runLength;
+
+  int offset = 0;
+  uint32_t start = nowUs();
+  for (uint32_t i = 0; i < runs; i++) {
+    PixelFill::fillScalar(buf + offset, runLength, (uint16_t)i);
+    offset += runLength + 1;
+    if (offset + runLength > capacity) {
+      offset = (int)(i & 1);
+    }
+  }
+  result.scalarUs = nowUs() - start;
+
+  offset = 0;
+  start = nowUs();
+  for (uint32_t i = 0; i < runs; i++) {
+    PixelFill::fill(buf + offset, runLength, (uint16_t)i);
+    offset += runLength + 1;
+    if (offset + runLength > capacity) {
+      offset = (int)(i & 1);
+    }
+  }
+  result.wordUs = nowUs() - start;
+  return result;
+}
+
+}  // namespace PixelFillBench
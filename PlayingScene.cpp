@@ -6,38 +6,94 @@ PlayingScene::PlayingScene(SokobanGame& gameRef) : game(gameRef) {}
 
 void PlayingScene::onEnter() {
   // `loadLevel()` marks dirty regions before entering the scene.
+  game.screenshotSource = SokobanGame::ScreenshotSource::Playfield;
+  game.fireConfirm.reset();
+  fireHeldTime = 0.0f;
+  fireHoldHandled = true;
 }
 
 void PlayingScene::onPhysics(float delta) {
+#if SOKOBAN_ENDLESS
+  if (game.generatingLevel) {
+    // The solved overlay stays up until the next level is ready.
+    game.stepLevelGeneration();
+    return;
+  }
+#endif
   if (game.levelSolved) {
     game.levelSolvedTimer += delta;
-    if (game.fireAction.justPressed() ||
-        game.levelSolvedTimer >= SokobanGame::LEVEL_SOLVED_DELAY_S) {
+    if (game.buttons.fire.justPressed()) {
+      // The release of this press must not restart the next level.
+      fireHoldHandled = true;
+      game.advanceAfterLevelSolved();
+      return;
+    }
+    if (game.levelSolvedTimer >= SokobanGame::LEVEL_SOLVED_DELAY_S) {
       game.advanceAfterLevelSolved();
     }
     return;
   }
 
-  if (game.fireAction.justPressed()) {
-    game.loadLevel(game.currentLevel);
+  game.advanceLevelTimer(delta);
+  if (handleFire(delta)) {
     return;
   }
 
-  bool moved = false;
-  if (game.leftAction.justPressed()) {
-    moved = game.tryMove(-1, 0);
-  } else if (game.rightAction.justPressed()) {
-    moved = game.tryMove(1, 0);
-  } else if (game.upAction.justPressed()) {
-    moved = game.tryMove(0, -1);
-  } else if (game.downAction.justPressed()) {
-    moved = game.tryMove(0, 1);
+  int dx = 0;
+  int dy = 0;
+  if (game.buttons.left.justPressed()) {
+    dx = -1;
+  } else if (game.buttons.right.justPressed()) {
+    dx = 1;
+  } else if (game.buttons.up.justPressed()) {
+    dy = -1;
+  } else if (game.buttons.down.justPressed()) {
+    dy = 1;
+  }
+  if (dx == 0 && dy == 0) {
+    return;
   }
 
-  (void)moved;
+  if (game.cursorActive) {
+    game.moveWalkCursor(dx, dy);
+  } else {
+    game.tryMove(dx, dy);
+  }
 }
 
 void PlayingScene::onProcess(float delta) {
+#if SOKOBAN_TARGET_PULSE
+  game.advanceTargetPulse(delta);
+#else
   (void)delta;
+#endif
   game.flushDirty();
 }
+
+bool PlayingScene::handleFire(float delta) {
+  // Holding FIRE toggles the cursor; a short press restarts the level, or while the cursor is
+  // shown walks to it / selects the box under it / pushes the selected box to it. Short
+  // presses act on release so a hold is never mistaken for one.
+  if (game.buttons.fire.justPressed()) {
+    fireHeldTime = 0.0f;
+    fireHoldHandled = false;
+  } else if (game.buttons.firePin.pressed() && !fireHoldHandled) {
+    fireHeldTime += delta;
+    if (fireHeldTime >= CURSOR_HOLD_S) {
+      fireHoldHandled = true;
+      game.toggleWalkCursor();
+      return true;
+    }
+  }
+
+  if (!game.fireConfirm.update(game.buttons.fire) || fireHoldHandled) {
+    return false;
+  }
+  fireHoldHandled = true;
+  if (game.cursorActive) {
+    game.confirmCursor();
+  } else {
+    game.loadLevel(game.currentLevel);
+  }
+  return true;
+}
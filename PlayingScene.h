@@ -13,5 +13,11 @@ public:
   void onProcess(float delta) override;
 
 private:
+  static constexpr float CURSOR_HOLD_S = 0.5f;
+
   SokobanGame& game;
+  float fireHeldTime = 0.0f;
+  bool fireHoldHandled = true;
+
+  bool handleFire(float delta);
 };
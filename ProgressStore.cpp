@@ -0,0 +1,108 @@
+#include "ProgressStore.h"
+
+#include <stddef.h>
+
+#include "Crc32.h"
+
+// The CRC covers the raw bytes, so the record must not contain padding.
+static_assert(sizeof(ProgressData) == 4 + 4 * SokobanLevels::LEVEL_COUNT, "ProgressData padding");
+
+ProgressStore::ProgressStore(IProgressStorage& storageRef) : storage(storageRef) {}
+
+void ProgressStore::begin() {
+  storage.begin();
+  progress = ProgressData();
+  lastSequence = 0;
+  lastSlot = -1;
+  pending = false;
+
+  slots = (int)(storage.size() / sizeof(Record));
+  if (slots > MAX_SLOTS) {
+    slots = MAX_SLOTS;
+  }
+
+  Record record;
+  for (int slot = 0; slot < slots; slot++) {
+    if (!storage.read((uint32_t)(slot * sizeof(Record)), &record, sizeof(record))) {
+      continue;
+    }
+    if (record.magic != RECORD_MAGIC || record.crc != recordCrc(record)) {
+      continue;
+    }
+    if (record.data.levelCount != SokobanLevels::LEVEL_COUNT) {
+      continue;
+    }
+    if (lastSlot < 0 || record.sequence > lastSequence) {
+      lastSequence = record.sequence;
+      lastSlot = slot;
+      progress = record.data;
+    }
+  }
+}
+
+const ProgressData& ProgressStore::data() const {
+  return progress;
+}
+
+bool ProgressStore::isUnlocked(uint8_t levelIndex) const {
+  return levelIndex < progress.unlockedLevels;
+}
+
+void ProgressStore::recordLevelSolved(uint8_t levelIndex, uint32_t moves, uint32_t pushes) {
+  if (levelIndex >= SokobanLevels::LEVEL_COUNT) {
+    return;
+  }
+
+  uint16_t clampedMoves = moves > 0xFFFFu ? 0xFFFFu : (uint16_t)moves;
+  uint16_t clampedPushes = pushes > 0xFFFFu ? 0xFFFFu : (uint16_t)pushes;
+  uint16_t& bestMoves = progress.bestMoves[levelIndex];
+  if (bestMoves == 0 || clampedMoves < bestMoves ||
+      (clampedMoves == bestMoves && clampedPushes < progress.bestPushes[levelIndex])) {
+    bestMoves = clampedMoves;
+    progress.bestPushes[levelIndex] = clampedPushes;
+  }
+
+  uint8_t next = (uint8_t)(levelIndex + 1);
+  if (next >= SokobanLevels::LEVEL_COUNT) {
+    next = levelIndex;
+  }
+  if (progress.unlockedLevels < next + 1) {
+    progress.unlockedLevels = (uint8_t)(next + 1);
+  }
+  progress.lastLevel = next;
+  pending = true;
+}
+
+bool ProgressStore::flush() {
+  if (!pending || slots == 0) {
+    return false;
+  }
+
+  Record record{};
+  record.magic = RECORD_MAGIC;
+  record.sequence = lastSequence + 1;
+  record.data = progress;
+  record.crc = recordCrc(record);
+
+  int slot = (lastSlot + 1) % slots;
+  if (!storage.write((uint32_t)(slot * sizeof(Record)), &record, sizeof(record)) ||
+      !storage.commit()) {
+    return false;
+  }
+  lastSlot = slot;
+  lastSequence = record.sequence;
+  pending = false;
+  return true;
+}
+
+uint32_t ProgressStore::sequence() const {
+  return lastSequence;
+}
+
+int ProgressStore::slotCount() const {
+  return slots;
+}
+
+uint32_t ProgressStore::recordCrc(const Record& record) {
+  return crc32(&record, offsetof(Record, crc));
+}
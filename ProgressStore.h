@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "IProgressStorage.h"
+#include "SokobanLevels.h"
+
+struct ProgressData {
+  uint8_t levelCount = SokobanLevels::LEVEL_COUNT;
+  uint8_t unlockedLevels = 1;
+  uint8_t lastLevel = 0;
+  uint8_t reserved = 0;
+  // 0 means the level has not been solved yet.
+  uint16_t bestMoves[SokobanLevels::LEVEL_COUNT]{};
+  uint16_t bestPushes[SokobanLevels::LEVEL_COUNT]{};
+};
+
+// Player progress kept as an append-only ring of CRC-checked snapshots. Every flush writes
+// the next slot with a higher sequence number, so writes rotate over the whole region
+// (wear-leveling) and a torn write only loses that one snapshot. Loading reads the fixed
+// number of slots once at boot, independent of how often progress was saved.
+class ProgressStore {
+public:
+  explicit ProgressStore(IProgressStorage& storageRef);
+
+  // Opens the storage backend and loads the newest valid snapshot.
+  void begin();
+  const ProgressData& data() const;
+  bool isUnlocked(uint8_t levelIndex) const;
+
+  // Updates the RAM copy only; nothing reaches storage until `flush()`.
+  void recordLevelSolved(uint8_t levelIndex, uint32_t moves, uint32_t pushes);
+  bool flush();
+
+  uint32_t sequence() const;
+  int slotCount() const;
+
+private:
+  static constexpr uint32_t RECORD_MAGIC = 0x31504B53u;  // "SKP1"
+  static constexpr int MAX_SLOTS = 32;
+
+  struct Record {
+    uint32_t magic;
+    uint32_t sequence;
+    ProgressData data;
+    uint32_t crc;
+  };
+
+  IProgressStorage& storage;
+  ProgressData progress;
+  uint32_t lastSequence = 0;
+  int lastSlot = -1;
+  int slots = 0;
+  bool pending = false;
+
+  static uint32_t recordCrc(const Record& record);
+};
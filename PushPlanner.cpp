@@ -0,0 +1,121 @@
+#include "PushPlanner.h"
+
+#include <string.h>
+
+using namespace SokobanRules;
+
+int PushPlanner::plan(const Board& board,
+                      int boardWIn,
+                      int boardHIn,
+                      int playerX,
+                      int playerY,
+                      int boxX,
+                      int boxY,
+                      int toX,
+                      int toY) {
+  pushCount = 0;
+  boardW = boardWIn;
+  boardH = boardHIn;
+  if (toX < 0 || toX >= boardW || toY < 0 || toY >= boardH || !isBox(board[boxY][boxX])) {
+    return -1;
+  }
+  if (boxX == toX && boxY == toY) {
+    return 0;
+  }
+  if (!isFreeForBox(board[toY][toX])) {
+    return -1;
+  }
+
+  // The planned box and the player move around, so they are lifted off the working copy.
+  memcpy(work, board, sizeof(work));
+  work[boxY][boxX] = withoutBox(work[boxY][boxX]);
+  work[playerY][playerX] = withoutPlayer(work[playerY][playerX]);
+  memset(seen, 0, sizeof(seen));
+
+  int goalIndex = toY * BOARD_MAX_W + toX;
+  int head = 0;
+  int tail = 0;
+  int goal = expand(boxY * BOARD_MAX_W + boxX, playerX, playerY, NO_PARENT, goalIndex, tail);
+
+  while (goal < 0 && head < tail) {
+    uint16_t state = queue[head++];
+    int boxIndex = state / DIR_COUNT;
+    int dir = state % DIR_COUNT;
+    // After a push the player stands on the cell the box just left.
+    int px = boxIndex % BOARD_MAX_W - DIR_DX[dir];
+    int py = boxIndex / BOARD_MAX_W - DIR_DY[dir];
+    goal = expand(boxIndex, px, py, state, goalIndex, tail);
+  }
+
+  if (goal < 0) {
+    return -1;
+  }
+  buildPushList(goal);
+  return pushCount;
+}
+
+int PushPlanner::length() const {
+  return pushCount;
+}
+
+Dir PushPlanner::push(int index) const {
+  return static_cast<Dir>(pushes[index]);
+}
+
+int PushPlanner::expand(
+  int boxIndex, int playerX, int playerY, uint16_t from, int goalIndex, int& tail) {
+  int bx = boxIndex % BOARD_MAX_W;
+  int by = boxIndex / BOARD_MAX_W;
+  char saved = work[by][bx];
+  work[by][bx] = withBox(saved);
+  reach.floodReachable(work, boardW, boardH, playerX, playerY);
+  work[by][bx] = saved;
+
+  for (int dir = 0; dir < DIR_COUNT; dir++) {
+    int sx = bx - DIR_DX[dir];
+    int sy = by - DIR_DY[dir];
+    int nx = bx + DIR_DX[dir];
+    int ny = by + DIR_DY[dir];
+    if (sx < 0 || sx >= boardW || sy < 0 || sy >= boardH) {
+      continue;
+    }
+    if (nx < 0 || nx >= boardW || ny < 0 || ny >= boardH) {
+      continue;
+    }
+    if (!reach.reachable(sx, sy) || !isFreeForBox(work[ny][nx])) {
+      continue;
+    }
+    int next = (ny * BOARD_MAX_W + nx) * DIR_COUNT + dir;
+    if (isSeen(next)) {
+      continue;
+    }
+    markSeen(next);
+    parent[next] = from;
+    if (ny * BOARD_MAX_W + nx == goalIndex) {
+      return next;
+    }
+    queue[tail++] = (uint16_t)next;
+  }
+  return -1;
+}
+
+bool PushPlanner::isSeen(int state) const {
+  return (seen[state >> 3] & (uint8_t)(1u << (state & 7))) != 0;
+}
+
+void PushPlanner::markSeen(int state) {
+  seen[state >> 3] |= (uint8_t)(1u << (state & 7));
+}
+
+void PushPlanner::buildPushList(int goalState) {
+  uint16_t state = (uint16_t)goalState;
+  while (state != NO_PARENT && pushCount < MAX_PUSHES) {
+    pushes[pushCount++] = (uint8_t)(state % DIR_COUNT);
+    state = parent[state];
+  }
+  for (int i = 0, j = pushCount - 1; i < j; i++, j--) {
+    uint8_t tmp = pushes[i];
+    pushes[i] = pushes[j];
+    pushes[j] = tmp;
+  }
+}
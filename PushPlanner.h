@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "PathFinder.h"
+#include "SokobanRules.h"
+
+// Shortest push sequence that moves one box to a destination while every other box stays
+// where it is. Breadth-first over (box cell, side the player pushed from) states; between
+// pushes the player's reachable area is re-flooded with the box at its new cell. All buffers
+// are fixed-size members.
+class PushPlanner {
+public:
+  static constexpr int MAX_PUSHES = SokobanRules::BOARD_MAX_CELLS * SokobanRules::DIR_COUNT;
+
+  // Returns the number of pushes, 0 when the box already sits on the destination, or -1 when
+  // no push sequence exists. The push directions are available through `push()`.
+  int plan(const SokobanRules::Board& board,
+           int boardW,
+           int boardH,
+           int playerX,
+           int playerY,
+           int boxX,
+           int boxY,
+           int toX,
+           int toY);
+
+  int length() const;
+  SokobanRules::Dir push(int index) const;
+
+private:
+  static constexpr int STATE_COUNT = MAX_PUSHES;
+  static constexpr uint16_t NO_PARENT = 0xFFFF;
+
+  SokobanRules::Board work{};
+  PathFinder reach;
+  uint16_t queue[STATE_COUNT]{};
+  uint16_t parent[STATE_COUNT]{};
+  uint8_t seen[(STATE_COUNT + 7) / 8]{};
+  uint8_t pushes[MAX_PUSHES]{};
+  int pushCount = 0;
+  int boardW = 0;
+  int boardH = 0;
+
+  // Queues every push available to a player standing at (playerX, playerY) with the box at
+  // `boxIndex`. Returns the state that reaches `goalIndex`, or -1.
+  int expand(int boxIndex, int playerX, int playerY, uint16_t from, int goalIndex, int& tail);
+  bool isSeen(int state) const;
+  void markSeen(int state);
+  void buildPushList(int goalState);
+};
@@ -0,0 +1,364 @@
+#include "RaceScene.h"
+
+#if SOKOBAN_RACE
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SokobanGame.h"
+
+namespace {
+
+constexpr int HUD_TEXT_Y = 3;
+constexpr int HUD_STATUS_Y = 12;
+// Rows per text line at scale 1: 7 glyph rows plus one spare.
+constexpr int TEXT_H = 8;
+const char* const RACE_HINT = "FIRE - RESTART";
+const char* const OVER_HINT = "FIRE - MENU";
+
+}  // namespace
+
+RaceScene::RaceScene(SokobanGame& gameRef) : game(gameRef) {}
+
+bool RaceScene::begin(uint8_t levelIndex) {
+  // The boards share the game's sprite caches, which the render task must be done with.
+  game.waitForRenderIdle();
+  level = levelIndex;
+  splitX = game.screenW / 2;
+  for (int i = 0; i < PLAYERS; i++) {
+    if (!loadBoard(racers[i], i)) {
+      return false;
+    }
+    racers[i].hudText[0] = '\0';
+  }
+  raceTimeUs = 0;
+  raceTenths = 0;
+  winner = -1;
+  statusText[0] = '\0';
+  return true;
+}
+
+void RaceScene::onEnter() {
+  game.screenshotSource = SokobanGame::ScreenshotSource::Race;
+  game.fireConfirm.reset();
+  game.rivalFireConfirm.reset();
+  refreshTexts();
+  for (Racer& racer : racers) {
+    racer.dirtyCells.clear();
+  }
+  game.dirty.invalidate(game.renderTarget);
+}
+
+void RaceScene::onPhysics(float delta) {
+  // Both confirms are updated every step so a press is never carried into a later one.
+  const bool fire = game.fireConfirm.update(game.buttons.fire);
+  const bool rivalFire = game.rivalFireConfirm.update(game.rivalButtons.fire);
+  if (winner >= 0) {
+    if (fire || rivalFire) {
+      leave();
+    }
+    return;
+  }
+  if (fire) {
+    restart(0);
+  }
+  if (rivalFire) {
+    restart(1);
+  }
+
+  raceTenths = SokobanGame::advanceTimerUs(raceTimeUs, delta);
+  steer(0, game.buttons);
+  steer(1, game.rivalButtons);
+}
+
+void RaceScene::onProcess(float delta) {
+  (void)delta;
+  // HUD and margins go through the shared flusher; each board flushes its own cells. Pushes
+  // go straight to the panel, past the tile signatures (see `leave()`).
+  game.flusher.flush(
+    game.renderTarget, game.regionBuf, [this](int x0, int y0, int w, int h, uint16_t* buf) {
+      renderRegion(x0, y0, w, h, buf);
+#if SOKOBAN_RENDER_STATS
+      pushedPixels[PLAYERS] += (uint32_t)(w * h);
+#endif
+    });
+  for (int i = 0; i < PLAYERS; i++) {
+    racers[i].dirtyCells.flush([this, i](int x0, int y0, int w, int h) {
+      renderRegion(x0, y0, w, h, game.regionBuf);
+      game.renderTarget.drawRGB565(x0, y0, w, h, game.regionBuf);
+#if SOKOBAN_RENDER_STATS
+      pushedPixels[i] += (uint32_t)(w * h);
+#else
+      (void)i;
+#endif
+    });
+  }
+#if SOKOBAN_RENDER_STATS
+  reportPushes();
+#endif
+}
+
+bool RaceScene::loadBoard(Racer& racer, int index) {
+  BoardViewport& v = racer.viewport;
+  if (!game.loadPackLevel(level, v.board, v.boardW, v.boardH)) {
+    return false;
+  }
+  racer.remainingCrates = 0;
+  racer.moves = 0;
+  bool playerFound = false;
+  for (int y = 0; y < v.boardH; y++) {
+    for (int x = 0; x < v.boardW; x++) {
+      char cell = v.board[y][x];
+      if (cell == '@' || cell == '+') {
+        racer.playerX = x;
+        racer.playerY = y;
+        playerFound = true;
+      }
+      if (cell == '$') {
+        racer.remainingCrates++;
+      }
+    }
+  }
+  if (!playerFound) {
+    return false;
+  }
+
+  // Both halves are `splitX` wide, so both boards get the same tile and share sprite art.
+  v.fit(index * splitX, HUD_H, splitX, game.screenH - HUD_H, MIN_TILE, SokobanGame::MAX_TILE_SIZE);
+  racer.dirtyCells.setBoard(v.boardX0,
+                            v.boardY0,
+                            v.boardW,
+                            v.boardH,
+                            v.tileSize,
+                            SokobanGame::MAX_TILE_W * SokobanGame::MAX_TILE_H);
+  game.bindSpriteArt(v.tileSize);
+  game.bindTargetRings(v.tileSize);
+  v.targetRing = &game.targetRings[0];
+  racer.sprites.setGeometry(v.boardX0, v.boardY0, v.tileSize);
+  racer.sprites.setPalette(game.themeColors);
+  syncSprites(racer);
+  return true;
+}
+
+void RaceScene::steer(int index, const ButtonSet& buttons) {
+  int dx = 0;
+  int dy = 0;
+  if (buttons.left.justPressed()) {
+    dx = -1;
+  } else if (buttons.right.justPressed()) {
+    dx = 1;
+  } else if (buttons.up.justPressed()) {
+    dy = -1;
+  } else if (buttons.down.justPressed()) {
+    dy = 1;
+  }
+  if ((dx == 0 && dy == 0) || winner >= 0) {
+    return;
+  }
+
+  Racer& racer = racers[index];
+  if (!tryMove(racer, dx, dy)) {
+    return;
+  }
+  racer.moves++;
+  if (racer.remainingCrates == 0) {
+    winner = index;
+  }
+  refreshTexts();
+}
+
+bool RaceScene::tryMove(Racer& racer, int dx, int dy) {
+  BoardViewport& v = racer.viewport;
+  const int nx = racer.playerX + dx;
+  const int ny = racer.playerY + dy;
+  if (!v.inBounds(nx, ny)) {
+    return false;
+  }
+
+  char& next = v.board[ny][nx];
+  if (SokobanRules::isBox(next)) {
+    const int bx = nx + dx;
+    const int by = ny + dy;
+    if (!v.inBounds(bx, by) || !SokobanRules::isFreeForBox(v.board[by][bx])) {
+      return false;
+    }
+    char& beyond = v.board[by][bx];
+    if (next == '*') {
+      racer.remainingCrates++;
+    }
+    if (beyond == '.') {
+      racer.remainingCrates--;
+    }
+    next = SokobanRules::withoutBox(next);
+    beyond = SokobanRules::withBox(beyond);
+    markCellDirty(racer, bx, by);
+  } else if (!SokobanRules::isFreeForPlayer(next)) {
+    return false;
+  }
+
+  char& here = v.board[racer.playerY][racer.playerX];
+  here = SokobanRules::withoutPlayer(here);
+  next = SokobanRules::withPlayer(next);
+  markCellDirty(racer, racer.playerX, racer.playerY);
+  markCellDirty(racer, nx, ny);
+  racer.playerX = nx;
+  racer.playerY = ny;
+  syncSprites(racer);
+  return true;
+}
+
+void RaceScene::restart(int index) {
+  // Same level and layout, so only this board's cells need repainting.
+  Racer& racer = racers[index];
+  loadBoard(racer, index);
+  racer.dirtyCells.markAll();
+  refreshTexts();
+}
+
+void RaceScene::leave() {
+#if SOKOBAN_TILE_SIGNATURES
+  // The race drew past the signature cache, so it no longer knows what is on the panel.
+  game.tileSignatures.invalidateAll();
+#endif
+  game.sceneSwitcher.switchTo(game.levelSelectScene);
+  game.resetClock();
+}
+
+void RaceScene::syncSprites(Racer& racer) {
+  const BoardViewport& v = racer.viewport;
+  int slot = 0;
+  for (int y = 0; y < v.boardH; y++) {
+    for (int x = 0; x < v.boardW; x++) {
+      if (SokobanRules::isBox(v.board[y][x]) && slot < PLAYER_SLOT) {
+        racer.sprites.setPosition(slot++, v.cellX(x), v.cellY(y), game.boxSpritePixels);
+      }
+    }
+  }
+  for (; slot < PLAYER_SLOT; slot++) {
+    racer.sprites.hide(slot);
+  }
+  racer.sprites.setPosition(
+    PLAYER_SLOT, v.cellX(racer.playerX), v.cellY(racer.playerY), game.playerSpritePixels);
+}
+
+void RaceScene::refreshTexts() {
+  // Each racer's line is marked within its own half, so a move repaints no pixel of the
+  // other player's side.
+  char buf[sizeof(statusText)];
+  for (int i = 0; i < PLAYERS; i++) {
+    Racer& racer = racers[i];
+    if (i == winner) {
+      snprintf(buf,
+               sizeof(buf),
+               "P%d META %lu.%luS",
+               i + 1,
+               (unsigned long)(raceTenths / 10u),
+               (unsigned long)(raceTenths % 10u));
+    } else {
+      snprintf(buf, sizeof(buf), "P%d RUCHY %u", i + 1, (unsigned)racer.moves);
+    }
+    if (strcmp(buf, racer.hudText) == 0) {
+      continue;
+    }
+    memcpy(racer.hudText, buf, sizeof(racer.hudText));
+    racer.hudX = i * splitX + (splitX - Font5x7::textWidth(buf, 1)) / 2;
+    game.dirty.add(i * splitX, HUD_TEXT_Y, (i + 1) * splitX - 1, HUD_TEXT_Y + TEXT_H - 1);
+  }
+
+  const char* status = (winner < 0) ? RACE_HINT : OVER_HINT;
+  if (strcmp(status, statusText) != 0) {
+    strncpy(statusText, status, sizeof(statusText) - 1);
+    statusX = (game.screenW - Font5x7::textWidth(statusText, 1)) / 2;
+    game.dirty.add(0, HUD_STATUS_Y, game.screenW - 1, HUD_STATUS_Y + TEXT_H - 1);
+  }
+}
+
+void RaceScene::markCellDirty(Racer& racer, int gx, int gy) {
+  const BoardViewport& v = racer.viewport;
+  const int x = v.cellX(gx);
+  const int y = v.cellY(gy);
+  racer.dirtyCells.add(
+    x, y, x + v.tileSize - 1, y + v.tileSize - 1, [this](int x0, int y0, int x1, int y1) {
+      game.dirty.add(x0, y0, x1, y1);
+    });
+}
+
+#if SOKOBAN_RENDER_STATS
+void RaceScene::reportPushes() {
+  if (pushedPixels[0] == 0 && pushedPixels[1] == 0 && pushedPixels[PLAYERS] == 0) {
+    return;
+  }
+  Serial.print("[race] pushed px P1 ");
+  Serial.print((unsigned long)pushedPixels[0]);
+  Serial.print(" P2 ");
+  Serial.print((unsigned long)pushedPixels[1]);
+  Serial.print(" other ");
+  Serial.println((unsigned long)pushedPixels[PLAYERS]);
+  for (uint32_t& pixels : pushedPixels) {
+    pixels = 0;
+  }
+}
+#endif
+
+void RaceScene::hudRow(int y, int xs, int xe, uint16_t* row) const {
+  const uint16_t* colors = game.themeColors;
+  if (y >= HUD_H - 2) {
+    PixelFill::fill(row, xe - xs, colors[Theme::PANEL_LINE]);
+    return;
+  }
+  PixelFill::fill(row, xe - xs, colors[Theme::PANEL]);
+  for (int i = 0; i < PLAYERS; i++) {
+    const Racer& racer = racers[i];
+    SokobanGame::PlayfieldView::textRow(row,
+                                        xs,
+                                        xe,
+                                        y,
+                                        racer.hudText,
+                                        1,
+                                        racer.hudX,
+                                        HUD_TEXT_Y,
+                                        colors[(i == winner) ? Theme::ACCENT : Theme::TEXT]);
+  }
+  SokobanGame::PlayfieldView::textRow(
+    row, xs, xe, y, statusText, 1, statusX, HUD_STATUS_Y, colors[Theme::TEXT_DIM]);
+}
+
+void RaceScene::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+  const uint16_t* colors = game.themeColors;
+  const int xs = (x0 > 0) ? x0 : 0;
+  const int xe = (x0 + w < game.screenW) ? x0 + w : game.screenW;
+
+  for (int yy = 0; yy < h; yy++) {
+    int y = y0 + yy;
+    uint16_t* row = buf + yy * w;
+    if (y < 0 || y >= game.screenH || xs >= xe) {
+      PixelFill::fill(row, w, colors[Theme::BG]);
+      continue;
+    }
+    PixelFill::fill(row, xs - x0, colors[Theme::BG]);
+    uint16_t* out = row + (xs - x0);
+    if (y < HUD_H) {
+      hudRow(y, xs, xe, out);
+    } else {
+      // Each half is drawn by its own board; the split column is a divider line.
+      const int mid = (splitX < xs) ? xs : ((splitX > xe) ? xe : splitX);
+      if (xs < mid) {
+        racers[0].viewport.boardRow(colors, y, xs, mid, out);
+      }
+      if (mid < xe) {
+        racers[1].viewport.boardRow(colors, y, mid, xe, out + (mid - xs));
+      }
+      if (splitX >= xs && splitX < xe) {
+        out[splitX - xs] = colors[Theme::PANEL_LINE];
+      }
+    }
+    PixelFill::fill(row + (xe - x0), x0 + w - xe, colors[Theme::BG]);
+  }
+
+  for (const Racer& racer : racers) {
+    racer.sprites.renderRegion(x0, y0, w, h, buf);
+  }
+}
+
+#endif
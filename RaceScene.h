@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SGF/Scene.h"
+#include "BoardViewport.h"
+#include "ButtonSet.h"
+#include "DirtyCellMap.h"
+#include "SpriteGrid.h"
+
+// Build with -DSOKOBAN_RACE=1 to let two players race through the same level side by side;
+// the second player's buttons come from the second `HardwareProfile` passed to `SokobanGame`.
+#ifndef SOKOBAN_RACE
+#define SOKOBAN_RACE 0
+#endif
+
+class SokobanGame;
+
+// Two boards, one per half of the screen, each with its own cells, sprites and dirty map: a
+// move marks only its own board's cells and flushes them in that board's grid chunks, so one
+// player's move never repaints the other's board. The first player to cover every target wins.
+class RaceScene : public Scene {
+public:
+  explicit RaceScene(SokobanGame& gameRef);
+
+  // Loads `levelIndex` onto both boards; switch to the scene afterwards.
+  bool begin(uint8_t levelIndex);
+
+  void onEnter() override;
+  void onPhysics(float delta) override;
+  void onProcess(float delta) override;
+
+  // Renders any screen region: HUD strip, both boards and their sprites.
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
+
+private:
+  static constexpr int PLAYERS = 2;
+  static constexpr int HUD_H = 22;
+  // A 14-cell-wide board still fits half of a 240 px panel at this size.
+  static constexpr int MIN_TILE = 8;
+  static constexpr int PLAYER_SLOT = SpriteGrid::MAX_SPRITES - 1;
+
+  struct Racer {
+    BoardViewport viewport;
+    DirtyCellMap dirtyCells;
+    SpriteGrid sprites;
+    int playerX;
+    int playerY;
+    int remainingCrates;
+    uint16_t moves;
+    char hudText[20];
+    int hudX;
+  };
+
+  SokobanGame& game;
+  Racer racers[PLAYERS]{};
+  uint8_t level = 0;
+  uint64_t raceTimeUs = 0;
+  uint32_t raceTenths = 0;
+  // Index of the first racer to cover every target; -1 while the race is on.
+  int winner = -1;
+  // Left edge of the second half; both halves are this wide.
+  int splitX = 0;
+  char statusText[20]{};
+  int statusX = 0;
+#if SOKOBAN_RENDER_STATS
+  // Pixels pushed this frame per board, and for the HUD and margins.
+  uint32_t pushedPixels[PLAYERS + 1]{};
+#endif
+
+  bool loadBoard(Racer& racer, int index);
+  void steer(int index, const ButtonSet& buttons);
+  bool tryMove(Racer& racer, int dx, int dy);
+  // Reloads one board; the other player keeps going.
+  void restart(int index);
+  void leave();
+  void syncSprites(Racer& racer);
+  // Rebuilds the HUD texts and marks only the lines that changed.
+  void refreshTexts();
+  void markCellDirty(Racer& racer, int gx, int gy);
+#if SOKOBAN_RENDER_STATS
+  void reportPushes();
+#endif
+  void hudRow(int y, int xs, int xe, uint16_t* row) const;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "DirtyLog.h"
+
+// Single-producer/single-consumer hand-off of render frames between the logic loop and a
+// render task, built on a lock-free triple buffer: the logic side always has a free slot to
+// capture into, the render side always draws the newest published frame, and neither waits
+// on the other. A frame that is superseded before the render side takes it is dropped, so
+// its dirty rects are carried into the next one until a frame is actually taken.
+template <class View, int MAX_RECTS = 16>
+class RenderQueue {
+public:
+  using Rects = DirtyLog<MAX_RECTS>;
+
+  struct Frame {
+    View view;
+    Rects rects;
+    uint32_t sequence = 0;
+  };
+
+  // Logic side.
+
+  void markDirty(int x0, int y0, int x1, int y1) {
+    pendingRects.add(x0, y0, x1, y1);
+  }
+
+  void markAll() {
+    pendingRects.markAll();
+  }
+
+  // Captures and publishes a frame when anything was marked since the last one. `capture`
+  // is called with the slot's view to fill. Returns false when there was nothing to publish.
+  template <class Capture>
+  bool publish(Capture&& capture) {
+    if (pendingRects.empty()) {
+      return false;
+    }
+    if ((middle.load(std::memory_order_acquire) & FRESH) == 0) {
+      // The render side took the previous frame, so its rects no longer need carrying.
+      unrenderedRects.clear();
+    }
+    unrenderedRects.merge(pendingRects);
+    pendingRects.clear();
+
+    Frame& frame = frames[back];
+    capture(frame.view);
+    frame.rects = unrenderedRects;
+    frame.sequence = ++publishedSequence;
+    back = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  // True once the render side has finished the newest published frame.
+  bool drained() const {
+    return renderedSequence.load(std::memory_order_acquire) == publishedSequence;
+  }
+
+  // Render side.
+
+  // Returns the newest published frame, or nullptr when nothing new was published since the
+  // last call. The frame stays valid until the next `acquire()`.
+  const Frame* acquire() {
+    if ((middle.load(std::memory_order_acquire) & FRESH) == 0) {
+      return nullptr;
+    }
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return &frames[front];
+  }
+
+  void release(const Frame& frame) {
+    renderedSequence.store(frame.sequence, std::memory_order_release);
+  }
+
+  // The frame the render side took last, or nullptr before the first one. Only safe to read
+  // from the logic side once `drained()` holds and nothing new was published.
+  const Frame* lastRendered() const {
+    return renderedSequence.load(std::memory_order_acquire) == 0 ? nullptr : &frames[front];
+  }
+
+private:
+  static constexpr uint8_t INDEX_MASK = 0x03;
+  static constexpr uint8_t FRESH = 0x04;
+
+  Frame frames[3]{};
+  uint8_t back = 0;
+  uint8_t front = 1;
+  std::atomic<uint8_t> middle{2};
+  Rects pendingRects;
+  Rects unrenderedRects;
+  uint32_t publishedSequence = 0;
+  std::atomic<uint32_t> renderedSequence{0};
+};
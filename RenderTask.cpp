@@ -0,0 +1,57 @@
+#include "RenderTask.h"
+
+#if SOKOBAN_DUAL_CORE
+
+#if defined(ESP32)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if CONFIG_FREERTOS_UNICORE
+#error "SOKOBAN_DUAL_CORE needs a dual-core ESP32"
+#endif
+
+namespace {
+
+constexpr uint32_t STACK_BYTES = 4096;
+constexpr UBaseType_t PRIORITY = 1;
+
+}  // namespace
+
+namespace RenderTask {
+
+bool start(void (*entry)(void*), void* ctx) {
+  // The Arduino loop task owns one core; the render task takes the other.
+  const BaseType_t core = (xPortGetCoreID() == 0) ? 1 : 0;
+  return xTaskCreatePinnedToCore(entry, "sokoban-render", STACK_BYTES, ctx, PRIORITY, nullptr,
+                                 core) == pdPASS;
+}
+
+void pause() {
+  // One tick also lets the idle task on this core feed its watchdog.
+  vTaskDelay(1);
+}
+
+}  // namespace RenderTask
+
+#else
+
+#include <chrono>
+#include <thread>
+
+namespace RenderTask {
+
+bool start(void (*entry)(void*), void* ctx) {
+  std::thread(entry, ctx).detach();
+  return true;
+}
+
+void pause() {
+  std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+}  // namespace RenderTask
+
+#endif
+
+#endif
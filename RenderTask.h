@@ -0,0 +1,18 @@
+#pragma once
+
+// Build with -DSOKOBAN_DUAL_CORE=1 to run the playfield flush on its own task: pinned to the
+// second core on dual-core ESP32 parts, or a std::thread on a host build.
+#ifndef SOKOBAN_DUAL_CORE
+#define SOKOBAN_DUAL_CORE 0
+#endif
+
+namespace RenderTask {
+
+// Starts `entry(ctx)` on the render core. `entry` must never return. Returns false when the
+// task could not be created.
+bool start(void (*entry)(void*), void* ctx);
+
+// Gives up the CPU briefly while one side waits for the other.
+void pause();
+
+}  // namespace RenderTask
@@ -0,0 +1,165 @@
+#include "RepaintSchedule.h"
+
+namespace {
+
+constexpr uint8_t RING_SIDES = 4;
+constexpr uint8_t MARGIN_COUNT = 4;
+
+int maxInt(int a, int b) {
+  return (a > b) ? a : b;
+}
+
+int minInt(int a, int b) {
+  return (a < b) ? a : b;
+}
+
+}  // namespace
+
+void RepaintSchedule::begin(const Layout& layoutIn) {
+  layout = layoutIn;
+  layout.centerX = maxInt(0, minInt(layout.centerX, layout.boardW - 1));
+  layout.centerY = maxInt(0, minInt(layout.centerY, layout.boardH - 1));
+  stage = Stage::Hud;
+  ring = 0;
+  maxRing = maxInt(maxInt(layout.centerX, layout.boardW - 1 - layout.centerX),
+                   maxInt(layout.centerY, layout.boardH - 1 - layout.centerY));
+  part = 0;
+  areaH = 0;
+}
+
+bool RepaintSchedule::active() const {
+  return stage != Stage::Done || areaH > 0;
+}
+
+bool RepaintSchedule::next(int& x, int& y, int& w, int& h) {
+  if (areaH <= 0 && !nextArea()) {
+    return false;
+  }
+  int rows = CHUNK_MAX_PIXELS / areaW;
+  rows = (rows < 1) ? 1 : rows;
+  rows = minInt(rows, areaH);
+  x = areaX;
+  y = areaY;
+  w = areaW;
+  h = rows;
+  areaY += rows;
+  areaH -= rows;
+  return true;
+}
+
+bool RepaintSchedule::nextArea() {
+  while (stage != Stage::Done) {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+    bool found = false;
+    if (stage == Stage::Hud) {
+      x = 0;
+      y = 0;
+      w = layout.screenW;
+      h = layout.hudH;
+      found = true;
+      stage = Stage::Rings;
+    } else if (stage == Stage::Rings) {
+      found = ringSide(x, y, w, h);
+      part++;
+      if (ring == 0 || part == RING_SIDES) {
+        part = 0;
+        ring++;
+      }
+      if (ring > maxRing) {
+        stage = Stage::Margins;
+      }
+    } else {
+      found = margin(x, y, w, h);
+      part++;
+      if (part == MARGIN_COUNT) {
+        stage = Stage::Done;
+      }
+    }
+    if (found && w > 0 && h > 0) {
+      areaX = x;
+      areaY = y;
+      areaW = w;
+      areaH = h;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RepaintSchedule::ringSide(int& x, int& y, int& w, int& h) const {
+  // Ring `ring` is the cells at Chebyshev distance `ring` from the centre: a top and a bottom
+  // row, and the left and right columns between them.
+  const int cx = layout.centerX;
+  const int cy = layout.centerY;
+  int gx0 = cx - ring;
+  int gx1 = cx + ring;
+  int gy0 = cy - ring;
+  int gy1 = cy + ring;
+  if (ring == 0 || part == 0) {
+    gy1 = gy0;
+  } else if (part == 1) {
+    gy0 = gy1;
+  } else {
+    gy0++;
+    gy1--;
+    if (part == 2) {
+      gx1 = gx0;
+    } else {
+      gx0 = gx1;
+    }
+  }
+  if (gy0 < 0 && gy1 == gy0) {
+    return false;
+  }
+  if (gx0 < 0 && gx1 == gx0) {
+    return false;
+  }
+  gx0 = maxInt(gx0, 0);
+  gy0 = maxInt(gy0, 0);
+  gx1 = minInt(gx1, layout.boardW - 1);
+  gy1 = minInt(gy1, layout.boardH - 1);
+  if (gx0 > gx1 || gy0 > gy1) {
+    return false;
+  }
+  x = layout.boardX0 + gx0 * layout.tileSize;
+  y = layout.boardY0 + gy0 * layout.tileSize;
+  w = (gx1 - gx0 + 1) * layout.tileSize;
+  h = (gy1 - gy0 + 1) * layout.tileSize;
+  return true;
+}
+
+bool RepaintSchedule::margin(int& x, int& y, int& w, int& h) const {
+  // Everything below the HUD that is not a board cell: full-width bands above and below the
+  // board, and the sides level with it. The board frame lies in these bands.
+  const int boardRight = layout.boardX0 + layout.boardW * layout.tileSize;
+  const int boardBottom = layout.boardY0 + layout.boardH * layout.tileSize;
+  switch (part) {
+    case 0:
+      x = 0;
+      y = layout.hudH;
+      w = layout.screenW;
+      h = layout.boardY0 - layout.hudH;
+      return true;
+    case 1:
+      x = 0;
+      y = boardBottom;
+      w = layout.screenW;
+      h = layout.screenH - boardBottom;
+      return true;
+    case 2:
+      x = 0;
+      y = layout.boardY0;
+      w = layout.boardX0;
+      h = boardBottom - layout.boardY0;
+      return true;
+    default:
+      x = boardRight;
+      y = layout.boardY0;
+      w = layout.screenW - boardRight;
+      h = boardBottom - layout.boardY0;
+      return true;
+  }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+// Splits a full playfield repaint into chunks that can be flushed a few per frame. Chunks come
+// HUD first, then board cells in rings of growing distance around a centre cell (the player),
+// then the margins around the board; together they cover the screen exactly once. No chunk
+// exceeds `CHUNK_MAX_PIXELS`, so one flush step stays short whatever the layout.
+class RepaintSchedule {
+public:
+  // 16 KB of RGB565, about 3.3 ms on a 40 MHz SPI bus; one 20-cell ring side at tile size 20.
+  static constexpr int CHUNK_MAX_PIXELS = 8192;
+
+  struct Layout {
+    int screenW;
+    int screenH;
+    int hudH;
+    int boardX0;
+    int boardY0;
+    int boardW;
+    int boardH;
+    int tileSize;
+    int centerX;
+    int centerY;
+  };
+
+  void begin(const Layout& layout);
+  bool active() const;
+  // Returns the next chunk to repaint, or false once the whole screen was handed out.
+  bool next(int& x, int& y, int& w, int& h);
+
+private:
+  enum class Stage : uint8_t { Hud, Rings, Margins, Done };
+
+  Layout layout{};
+  Stage stage = Stage::Done;
+  int ring = 0;
+  int maxRing = 0;
+  uint8_t part = 0;
+  // The area being handed out in row strips; empty when the next one must be picked.
+  int areaX = 0;
+  int areaY = 0;
+  int areaW = 0;
+  int areaH = 0;
+
+  bool nextArea();
+  bool ringSide(int& x, int& y, int& w, int& h) const;
+  bool margin(int& x, int& y, int& w, int& h) const;
+};
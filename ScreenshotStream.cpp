@@ -0,0 +1,110 @@
+#include "ScreenshotStream.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+
+#include "Crc32.h"
+
+namespace {
+
+int runLength(const uint16_t* row, int from, int width, int maxLen) {
+  int len = 1;
+  while (from + len < width && len < maxLen && row[from + len] == row[from]) {
+    len++;
+  }
+  return len;
+}
+
+int upLength(const uint16_t* row, const uint16_t* above, int from, int width, int maxLen) {
+  if (above == nullptr) {
+    return 0;
+  }
+  int len = 0;
+  while (from + len < width && len < maxLen && row[from + len] == above[from + len]) {
+    len++;
+  }
+  return len;
+}
+
+}  // namespace
+
+ScreenshotStream::ScreenshotStream(Print& outRef) : out(outRef) {}
+
+void ScreenshotStream::begin(int widthIn, int height) {
+  width = widthIn;
+  crc = 0;
+  encoded = 0;
+  outLen = 0;
+  char header[48];
+  snprintf(header, sizeof(header), "SOKOBAN-SHOT %d %d RLE565\n", width, height);
+  out.print(header);
+}
+
+void ScreenshotStream::writeRow(const uint16_t* row, const uint16_t* above) {
+  for (int x = 0; x < width; x++) {
+    uint8_t raw[2] = {(uint8_t)(row[x] & 0xFF), (uint8_t)(row[x] >> 8)};
+    crc = crc32Update(crc, raw, sizeof(raw));
+  }
+
+  int x = 0;
+  while (x < width) {
+    int up = upLength(row, above, x, width, MAX_UP);
+    int run = runLength(row, x, width, MAX_RUN);
+    if (up >= 2 && up >= run) {
+      put((uint8_t)(0x80 | (up - 1)));
+      x += up;
+      continue;
+    }
+    if (run >= 2) {
+      put((uint8_t)(0x40 | (run - 1)));
+      putPixel(row[x]);
+      x += run;
+      continue;
+    }
+
+    // Literal until a run or an up-copy is worth a packet of its own.
+    int start = x;
+    x++;
+    while (x < width && x - start < MAX_LITERAL) {
+      if (upLength(row, above, x, width, 2) >= 2 || runLength(row, x, width, 3) >= 3) {
+        break;
+      }
+      x++;
+    }
+    put((uint8_t)(x - start - 1));
+    for (int i = start; i < x; i++) {
+      putPixel(row[i]);
+    }
+  }
+}
+
+void ScreenshotStream::end() {
+  flushOut();
+  char trailer[24];
+  snprintf(trailer, sizeof(trailer), "\nEND %08lx\n", (unsigned long)crc);
+  out.print(trailer);
+}
+
+uint32_t ScreenshotStream::encodedBytes() const {
+  return encoded;
+}
+
+void ScreenshotStream::put(uint8_t byte) {
+  outBuf[outLen++] = byte;
+  encoded++;
+  if (outLen == OUT_BUF_BYTES) {
+    flushOut();
+  }
+}
+
+void ScreenshotStream::putPixel(uint16_t pixel) {
+  put((uint8_t)(pixel & 0xFF));
+  put((uint8_t)(pixel >> 8));
+}
+
+void ScreenshotStream::flushOut() {
+  if (outLen > 0) {
+    out.write(outBuf, (size_t)outLen);
+    outLen = 0;
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+class Print;
+
+// Streams a screen as run-length-encoded RGB565, one raster row at a time, so the sender only
+// needs the rows it has just rendered. Stream layout:
+//
+//   "SOKOBAN-SHOT <width> <height> RLE565\n"
+//   packets until width * height pixels are described
+//   "\nEND <crc32 of the raw little-endian pixels, 8 hex digits>\n"
+//
+// Packet control byte, followed by its pixels as little-endian uint16:
+//   0x00-0x3F  literal: the next n + 1 pixels follow (1..64)
+//   0x40-0x7F  run: one pixel follows, repeated n + 1 times (1..64)
+//   0x80-0xFF  up: the next n + 1 pixels equal the row above (1..128), no payload
+// Packets never span rows. `tools/screenshot_decode` turns a capture into a PNG.
+class ScreenshotStream {
+public:
+  static constexpr int MAX_LITERAL = 64;
+  static constexpr int MAX_RUN = 64;
+  static constexpr int MAX_UP = 128;
+
+  explicit ScreenshotStream(Print& out);
+
+  void begin(int width, int height);
+  // `above` is the previous screen row, or nullptr for the first row.
+  void writeRow(const uint16_t* row, const uint16_t* above);
+  void end();
+
+  uint32_t encodedBytes() const;
+
+private:
+  static constexpr int OUT_BUF_BYTES = 64;
+
+  Print& out;
+  int width = 0;
+  uint32_t crc = 0;
+  uint32_t encoded = 0;
+  uint8_t outBuf[OUT_BUF_BYTES]{};
+  int outLen = 0;
+
+  void put(uint8_t byte);
+  void putPixel(uint16_t pixel);
+  void flushOut();
+};
@@ -4,117 +4,65 @@
 #include <stdio.h>
 #include <string.h>
 
+#if SOKOBAN_MEMORY_REPORT
+#include "SokobanMemoryReport.h"
+#endif
+#if SOKOBAN_RENDER_STATS
+#include "PixelFillBench.h"
+#endif
+#if SOKOBAN_SCREENSHOT
+#include "ScreenshotStream.h"
+#endif
+
 namespace {
 
 void fillRectOnDisplay(void* ctx, int x, int y, int w, int h, uint16_t color565) {
   static_cast<IScreen*>(ctx)->fillRect565(x, y, w, h, color565);
 }
 
-const char* const LEVEL1_ROWS[] = {
-  "#####",
-  "#@$.#",
-  "#####"
-};
-
-const char* const LEVEL2_ROWS[] = {
-  "  ####",
-  "###  ####",
-  "#     $ #",
-  "# #  #$ #",
-  "# . .#@ #",
-  "#########"
-};
-
-const char* const LEVEL3_ROWS[] = {
-  "########",
-  "#      #",
-  "# .**$@#",
-  "#      #",
-  "#####  #",
-  "    ####"
-};
-
-const char* const LEVEL4_ROWS[] = {
-  " #######",
-  " #     #",
-  " # .$. #",
-  "## $@$ #",
-  "#  .$. #",
-  "#      #",
-  "########"
-};
-
-const char* const LEVEL5_ROWS[] = {
-  "###### #####",
-  "#    ###   #",
-  "# $$     #@#",
-  "# $ #...   #",
-  "#   ########",
-  "#####"
-};
-
-const char* const LEVEL6_ROWS[] = {
-  "####",
-  "# .#",
-  "#  ###",
-  "#*@  #",
-  "#  $ #",
-  "#  ###",
-  "####"
-};
-
-const char* const LEVEL7_ROWS[] = {
-  "######",
-  "#    #",
-  "# #@ #",
-  "# $* #",
-  "# .* #",
-  "#    #",
-  "######"
-};
-
-const char* const LEVEL8_ROWS[] = {
-  "#######",
-  "#     #",
-  "# .$. #",
-  "# $.$ #",
-  "# .$. #",
-  "# $.$ #",
-  "#  @  #",
-  "#######"
-};
-
-const char* const LEVEL9_ROWS[] = {
-  "#####",
-  "#.  ##",
-  "#@$$ #",
-  "##   #",
-  " ##  #",
-  "  ##.#",
-  "   ###"
-};
-
-const char* const LEVEL10_ROWS[] = {
-  "      #####",
-  "      #.  #",
-  "      #.# #",
-  "#######.# #",
-  "# @ $ $ $ #",
-  "# # # # ###",
-  "#       #",
-  "#########"
-};
-
 constexpr int HUD_TITLE_Y = 8;
 constexpr int HUD_LEVEL_Y = 8;
 constexpr int HUD_MOVES_Y = 24;
 constexpr int HUD_TOTAL_Y = 24;
 constexpr int HUD_STATUS_Y = 24;
+constexpr int HUD_TIMER_Y = 34;
 constexpr int OVERLAY_TEXT1_Y_OFF = 10;
 constexpr int OVERLAY_TEXT2_Y_OFF = 30;
-
-constexpr int BOX_SPRITE_SLOT_COUNT = SpriteLayer::kMaxSprites - 1;
-constexpr int PLAYER_SPRITE_SLOT = SpriteLayer::kMaxSprites - 1;
+// Rows per text line at scale 1: 7 glyph rows plus one spare, so no glyph row is skipped.
+constexpr int FONT_CELL_H = 8;
+
+// Boxes fill the slots between the ghost and the player, so on a shared cell the player
+// covers a box and both cover the ghost.
+#if SOKOBAN_GHOST
+constexpr int GHOST_SPRITE_SLOT = 0;
+constexpr int FIRST_BOX_SPRITE_SLOT = 1;
+#else
+constexpr int FIRST_BOX_SPRITE_SLOT = 0;
+#endif
+constexpr int PLAYER_SPRITE_SLOT = SpriteGrid::MAX_SPRITES - 1;
+
+#if SOKOBAN_TARGET_PULSE
+// Pixels each marker frame's radii lose: the ring breathes in and out once per cycle.
+constexpr int PULSE_SHRINK[] = {0, 1, 2, 1};
+#endif
+
+#if SOKOBAN_RENDER_STATS
+void printFillBench(uint16_t* buf, int capacity) {
+  // Runs before the first frame, so the region buffer is free to scribble on.
+  constexpr uint32_t PIXELS_PER_RUN_LENGTH = 200000u;
+  Serial.println("[render] fill px/us: run scalar word");
+  for (int i = 0; i < PixelFillBench::RUN_COUNT; i++) {
+    PixelFillBench::Result r = PixelFillBench::measure(
+      buf, capacity, PixelFillBench::RUN_LENGTHS[i], PIXELS_PER_RUN_LENGTH, micros);
+    Serial.print("[render]   ");
+    Serial.print(r.runLength);
+    Serial.print(" ");
+    Serial.print(r.scalarUs ? (float)r.pixels / r.scalarUs : 0.0f);
+    Serial.print(" ");
+    Serial.println(r.wordUs ? (float)r.pixels / r.wordUs : 0.0f);
+  }
+}
+#endif
 
 int fitCenteredScale(int screenWidth, const char* text, int maxScale, int margin) {
   for (int scale = maxScale; scale >= 1; --scale) {
@@ -127,72 +75,85 @@ int fitCenteredScale(int screenWidth, const char* text, int maxScale, int margin
 
 }  // namespace
 
-const SokobanGame::LevelDef SokobanGame::LEVELS[LEVEL_COUNT] = {
-  {5, 3, LEVEL1_ROWS},
-  {9, 6, LEVEL2_ROWS},
-  {8, 6, LEVEL3_ROWS},
-  {8, 7, LEVEL4_ROWS},
-  {12, 6, LEVEL5_ROWS},
-  {6, 7, LEVEL6_ROWS},
-  {6, 7, LEVEL7_ROWS},
-  {7, 8, LEVEL8_ROWS},
-  {6, 7, LEVEL9_ROWS},
-  {11, 8, LEVEL10_ROWS},
-};
-
 SokobanGame::SokobanGame(
   IRenderTarget& renderTargetRef,
   IScreen& screenRef,
-  const SGFHardware::HardwareProfile& hardwareProfileIn)
+  const SGFHardware::HardwareProfile& hardwareProfileIn,
+  IProgressStorage& progressStorage,
+  const SGFHardware::HardwareProfile* rivalHardwareProfile)
   : Game(FRAME_DEFAULT_STEP_US, FRAME_MAX_STEP_US),
     renderTarget(renderTargetRef),
     screen(screenRef),
     hardwareProfile(hardwareProfileIn),
+#if SOKOBAN_TILE_SIGNATURES
+    tileSignatures(renderTargetRef),
+#endif
     dirty(),
     flusher(dirty, MAX_TILE_W, MAX_TILE_H),
     sprites(),
     sceneSwitcher(),
     titleScene(*this),
+    levelSelectScene(*this),
     playingScene(*this),
-    gameOverScene(*this) {
-  pinLeft = hardwareProfile.input.left;
-  pinRight = hardwareProfile.input.right;
-  pinUp = hardwareProfile.input.up;
-  pinDown = hardwareProfile.input.down;
-  pinFire = hardwareProfile.input.fire;
-
-  buildSpritePixels();
+    gameOverScene(*this),
+#if SOKOBAN_RACE
+    raceScene(*this),
+#endif
+    progress(progressStorage) {
+  regionRenderer = &PlayfieldView::renderRegion<0, 0>;
+#if SOKOBAN_RACE
+  if (rivalHardwareProfile != nullptr) {
+    rivalProfile = *rivalHardwareProfile;
+    rivalInputSet = true;
+  }
+#else
+  (void)rivalHardwareProfile;
+#endif
+
   initSpriteSlots();
 }
 
 void SokobanGame::setup() {
+#if SOKOBAN_FIXED_PANEL
+  // Matched on the size the render target reports, so no preset has to be named here; any
+  // other panel keeps the runtime-size renderer.
+  if (!useFixedPanel<240, 240>()) {
+    useFixedPanel<320, 240>();
+  }
+#endif
   start();
 }
 
 void SokobanGame::onSetup() {
-  leftPinInput.attach(pinLeft, true);
-  rightPinInput.attach(pinRight, true);
-  upPinInput.attach(pinUp, true);
-  downPinInput.attach(pinDown, true);
-  firePinInput.attach(pinFire, true);
-  leftPinInput.begin(INPUT_PULLUP);
-  rightPinInput.begin(INPUT_PULLUP);
-  upPinInput.begin(INPUT_PULLUP);
-  downPinInput.begin(INPUT_PULLUP);
-  firePinInput.begin(INPUT_PULLUP);
-
-  leftPinInput.resetFromPin();
-  rightPinInput.resetFromPin();
-  upPinInput.resetFromPin();
-  downPinInput.resetFromPin();
-  firePinInput.resetFromPin();
-
-  leftAction.reset(leftPinInput.pressed());
-  rightAction.reset(rightPinInput.pressed());
-  upAction.reset(upPinInput.pressed());
-  downAction.reset(downPinInput.pressed());
-  fireAction.reset(firePinInput.pressed());
+  screenW = renderTarget.width();
+  screenH = renderTarget.height();
+  packValid = SokobanLevels::verifyPack();
+
+  buttons.begin(hardwareProfile);
   fireConfirm.reset();
+#if SOKOBAN_RACE
+  if (rivalInputSet) {
+    rivalButtons.begin(rivalProfile);
+  }
+  rivalFireConfirm.reset();
+#endif
+  cacheTimerGlyphs();
+
+#if SOKOBAN_MEMORY_REPORT || SOKOBAN_RENDER_STATS || SOKOBAN_SCREENSHOT || \
+  SOKOBAN_LATENCY_PROBE
+  Serial.begin(115200);
+#endif
+#if SOKOBAN_MEMORY_REPORT
+  SokobanMemoryReport::print(Serial);
+#endif
+#if SOKOBAN_RENDER_STATS
+  printFillBench(regionBuf, MAX_TILE_W * MAX_TILE_H);
+#endif
+
+  progress.begin();
+#if SOKOBAN_DUAL_CORE
+  renderTaskStarted = RenderTask::start(&SokobanGame::renderTaskMain, this);
+#endif
 
   dirty.clear();
   sceneSwitcher.setInitial(titleScene);
@@ -200,50 +161,85 @@ void SokobanGame::onSetup() {
 }
 
 void SokobanGame::onPhysics(float delta) {
-  leftAction.update(leftPinInput.update());
-  rightAction.update(rightPinInput.update());
-  upAction.update(upPinInput.update());
-  downAction.update(downPinInput.update());
-  fireAction.update(firePinInput.update());
+  buttons.update();
+#if SOKOBAN_RACE
+  if (rivalInputSet) {
+    rivalButtons.update();
+  }
+#endif
+#if SOKOBAN_LATENCY_PROBE
+  // SGF debounces inside DebouncedInputPin, so the stamp is the poll that saw the debounced
+  // edge; the debounce window itself is not part of the measurement.
+  inputEdgeUs = 0;
+  if (buttons.left.justPressed() || buttons.right.justPressed() || buttons.up.justPressed() ||
+      buttons.down.justPressed()) {
+    inputEdgeUs = micros() | 1u;
+  }
+#endif
   sceneSwitcher.onPhysics(delta);
 }
 
 void SokobanGame::onProcess(float delta) {
   sceneSwitcher.onProcess(delta);
+#if SOKOBAN_SCREENSHOT
+  pollDebugCommands();
+#endif
 }
 
-void SokobanGame::startNewGame() {
-  currentLevel = 0;
+void SokobanGame::startNewGame(uint8_t firstLevel) {
+  currentLevel = firstLevel;
   completedLevels = 0;
   totalMoves = 0;
   finalMoves = 0;
   loadLevel(currentLevel);
 }
 
+bool SokobanGame::loadPackLevel(
+  uint8_t index, SokobanRules::Board& board, int& width, int& height) const {
+  return packValid && SokobanLevels::load(index, board, width, height);
+}
+
 void SokobanGame::loadLevel(uint8_t levelIndex) {
+#if SOKOBAN_ENDLESS
+  // Indices past the built-in set replay the last generated level.
+  if (levelIndex >= LEVEL_COUNT && !generator.done()) {
+    return;
+  }
+#else
   if (levelIndex >= LEVEL_COUNT) {
     return;
   }
+#endif
 
-  memset(board, ' ', sizeof(board));
-  boardW = LEVELS[levelIndex].width;
-  boardH = LEVELS[levelIndex].height;
+  if (levelIndex < LEVEL_COUNT &&
+      !loadPackLevel(levelIndex, viewport.board, viewport.boardW, viewport.boardH)) {
+    return;
+  }
+#if SOKOBAN_ENDLESS
+  if (levelIndex >= LEVEL_COUNT) {
+    viewport.boardW = generator.width();
+    viewport.boardH = generator.height();
+    memcpy(viewport.board, generator.board(), sizeof(viewport.board));
+  }
+#endif
+  parMoves = 0;
+  uint16_t parPushes = 0;
+  if (levelIndex < LEVEL_COUNT) {
+    SokobanLevels::par(levelIndex, parMoves, parPushes);
+  }
   currentLevel = levelIndex;
   levelMoves = 0;
+  levelPushes = 0;
   remainingCrates = 0;
   levelSolved = false;
   levelSolvedTimer = 0.0f;
+  cursorActive = false;
+  boxSelected = false;
 
   bool playerFound = false;
-  for (int y = 0; y < boardH; y++) {
-    const char* row = LEVELS[levelIndex].rows[y];
-    size_t rowLen = strlen(row);
-    for (int x = 0; x < boardW; x++) {
-      char cell = (x < (int)rowLen) ? row[x] : ' ';
-      if (cell == '\0') {
-        cell = ' ';
-      }
-      board[y][x] = cell;
+  for (int y = 0; y < viewport.boardH; y++) {
+    for (int x = 0; x < viewport.boardW; x++) {
+      char cell = viewport.board[y][x];
       if (cell == '@' || cell == '+') {
         playerX = x;
         playerY = y;
@@ -258,13 +254,21 @@ void SokobanGame::loadLevel(uint8_t levelIndex) {
   if (!playerFound) {
     playerX = 1;
     playerY = 1;
-    if (inBounds(playerX, playerY) && board[playerY][playerX] == ' ') {
-      board[playerY][playerX] = '@';
+    if (viewport.inBounds(playerX, playerY) && viewport.board[playerY][playerX] == ' ') {
+      viewport.board[playerY][playerX] = '@';
     }
   }
 
   updateBoardLayout();
   syncSpritesFromBoard();
+#if SOKOBAN_GHOST
+  resetGhost();
+#endif
+  cacheParGlyphs();
+  resetLevelTimer();
+#if SOKOBAN_TARGET_PULSE
+  resetTargetPulse();
+#endif
   refreshHudTexts();
   refreshOverlayTexts();
   updateLevelSolvedState();
@@ -277,12 +281,52 @@ void SokobanGame::advanceAfterLevelSolved() {
     loadLevel(completedLevels);
     return;
   }
+#if SOKOBAN_ENDLESS
+  startLevelGeneration();
+  return;
+#endif
 
   finalMoves = totalMoves;
   sceneSwitcher.switchTo(gameOverScene);
   resetClock();
 }
 
+#if SOKOBAN_ENDLESS
+void SokobanGame::startLevelGeneration() {
+  // Boards stay small enough for the largest tile size and get one more box every third
+  // generated level.
+  uint8_t generated = (uint8_t)(currentLevel + 1 - LEVEL_COUNT);
+  LevelGenerator::Params params;
+  params.width = 10;
+  params.height = 8;
+  params.boxes = (uint8_t)(2 + generated / 3);
+  if (params.boxes > 5) {
+    params.boxes = 5;
+  }
+  generatorSeed = generatorSeed * 1664525u + 1013904223u + micros();
+  generator.begin(generatorSeed, params);
+  generatingLevel = true;
+}
+
+void SokobanGame::stepLevelGeneration() {
+  uint32_t startUs = micros();
+  while (micros() - startUs < GENERATOR_BUDGET_US) {
+    if (!generator.step(GENERATOR_SLICE_MOVES)) {
+      continue;
+    }
+    if (generator.score() == 0) {
+      // Every candidate ended with all boxes home; try another seed.
+      startLevelGeneration();
+      continue;
+    }
+    generatingLevel = false;
+    loadLevel((currentLevel < LAST_LEVEL_NUMBER) ? (uint8_t)(currentLevel + 1)
+                                                 : LAST_LEVEL_NUMBER);
+    return;
+  }
+}
+#endif
+
 bool SokobanGame::tryMove(int dx, int dy) {
   if (dx == 0 && dy == 0) {
     return false;
@@ -295,7 +339,7 @@ bool SokobanGame::tryMove(int dx, int dy) {
   int oldPlayerY = playerY;
   int nx = playerX + dx;
   int ny = playerY + dy;
-  if (!inBounds(nx, ny)) {
+  if (!viewport.inBounds(nx, ny)) {
     return false;
   }
 
@@ -305,19 +349,19 @@ bool SokobanGame::tryMove(int dx, int dy) {
   int boxToX = 0;
   int boxToY = 0;
 
-  char next = board[ny][nx];
+  char next = viewport.board[ny][nx];
   if (next == '#') {
     return false;
   }
 
-  if (isBox(next)) {
+  if (SokobanRules::isBox(next)) {
     int bx = nx + dx;
     int by = ny + dy;
-    if (!inBounds(bx, by)) {
+    if (!viewport.inBounds(bx, by)) {
       return false;
     }
-    char beyond = board[by][bx];
-    if (!isFreeForBox(beyond)) {
+    char beyond = viewport.board[by][bx];
+    if (!SokobanRules::isFreeForBox(beyond)) {
       return false;
     }
     pushed = true;
@@ -327,89 +371,250 @@ bool SokobanGame::tryMove(int dx, int dy) {
     boxToY = by;
     removeBoxAt(boxFromX, boxFromY);
     placeBoxAt(boxToX, boxToY);
-  } else if (!isFreeForPlayer(next)) {
+  } else if (!SokobanRules::isFreeForPlayer(next)) {
     return false;
   }
 
-  clearPlayerAt(playerX, playerY);
-  placePlayerAt(nx, ny);
-  playerX = nx;
-  playerY = ny;
+  movePlayerTo(nx, ny);
 
   markCellDirty(oldPlayerX, oldPlayerY);
   markCellDirty(playerX, playerY);
   if (pushed) {
     markCellDirty(boxFromX, boxFromY);
     markCellDirty(boxToX, boxToY);
+    levelPushes++;
   }
 
   syncSpritesFromBoard();
 
   levelMoves++;
   totalMoves++;
+#if SOKOBAN_GHOST
+  runLog.append((dx < 0)   ? SokobanRules::DIR_LEFT
+                : (dx > 0) ? SokobanRules::DIR_RIGHT
+                : (dy < 0) ? SokobanRules::DIR_UP
+                           : SokobanRules::DIR_DOWN);
+  advanceGhost();
+#endif
   refreshHudTexts();
   updateLevelSolvedState();
+#if SOKOBAN_LATENCY_PROBE
+  if (inputEdgeUs != 0) {
+    latencyEdgeUs = inputEdgeUs;
+  }
+#endif
   return true;
 }
 
-bool SokobanGame::inBounds(int x, int y) const {
-  return x >= 0 && x < boardW && y >= 0 && y < boardH;
+void SokobanGame::toggleWalkCursor() {
+  if (levelSolved) {
+    return;
+  }
+  cursorActive = !cursorActive;
+  if (cursorActive) {
+    cursorX = playerX;
+    cursorY = playerY;
+  } else {
+    clearBoxSelection();
+  }
+  markCursorDirty();
+  refreshHudTexts();
 }
 
-bool SokobanGame::isBox(char cell) {
-  return cell == '$' || cell == '*';
+void SokobanGame::moveWalkCursor(int dx, int dy) {
+  int nx = cursorX + dx;
+  int ny = cursorY + dy;
+  if (!cursorActive || !viewport.inBounds(nx, ny)) {
+    return;
+  }
+  markCursorDirty();
+  cursorX = nx;
+  cursorY = ny;
+  markCursorDirty();
 }
 
-bool SokobanGame::isFreeForPlayer(char cell) {
-  return cell == ' ' || cell == '.';
+bool SokobanGame::confirmCursor() {
+  if (!cursorActive || levelSolved) {
+    return false;
+  }
+  if (boxSelected) {
+    return pushSelectedBoxToCursor();
+  }
+  if (SokobanRules::isBox(viewport.board[cursorY][cursorX])) {
+    boxSelected = true;
+    selectedX = cursorX;
+    selectedY = cursorY;
+    markCellDirty(selectedX, selectedY);
+    refreshHudTexts();
+    return false;
+  }
+  return walkToCursor();
 }
 
-bool SokobanGame::isFreeForBox(char cell) {
-  return cell == ' ' || cell == '.';
+bool SokobanGame::walkToCursor() {
+  int steps = pathFinder.findPath(
+    viewport.board, viewport.boardW, viewport.boardH, playerX, playerY, cursorX, cursorY);
+  if (steps == 0) {
+    toggleWalkCursor();
+    return false;
+  }
+  if (steps < 0) {
+    return false;
+  }
+
+  // The path only crosses free cells, so the whole walk is applied at once: one dirty pair
+  // for the start and end cells and one HUD refresh instead of one per step.
+  markCellDirty(playerX, playerY);
+  movePlayerTo(cursorX, cursorY);
+  cursorActive = false;
+  markCellDirty(playerX, playerY);
+  syncPlayerSprite();
+
+  levelMoves += (uint32_t)steps;
+  totalMoves += (uint32_t)steps;
+#if SOKOBAN_GHOST
+  for (int i = 0; i < steps; i++) {
+    runLog.append(pathFinder.step(i));
+  }
+  advanceGhost();
+#endif
+  refreshHudTexts();
+  return true;
 }
 
-void SokobanGame::clearPlayerAt(int x, int y) {
-  char& cell = board[y][x];
-  if (cell == '@') {
-    cell = ' ';
-  } else if (cell == '+') {
-    cell = '.';
+bool SokobanGame::pushSelectedBoxToCursor() {
+  if (cursorX == selectedX && cursorY == selectedY) {
+    clearBoxSelection();
+    refreshHudTexts();
+    return false;
+  }
+
+  uint32_t startUs = micros();
+  int pushes = pushPlanner.plan(viewport.board,
+                                viewport.boardW,
+                                viewport.boardH,
+                                playerX,
+                                playerY,
+                                selectedX,
+                                selectedY,
+                                cursorX,
+                                cursorY);
+  lastPlanUs = micros() - startUs;
+#if SOKOBAN_RENDER_STATS
+  Serial.print("[plan] pushes=");
+  Serial.print(pushes);
+  Serial.print(" in ");
+  Serial.print((unsigned long)lastPlanUs);
+  Serial.println(" us");
+#endif
+  if (pushes <= 0) {
+    return false;
+  }
+
+  // Replay the plan on the board only; the intermediate cells end up exactly as they were, so
+  // rendering is one batch for the player and box start/end cells.
+  int startPlayerX = playerX;
+  int startPlayerY = playerY;
+  int boxX = selectedX;
+  int boxY = selectedY;
+  uint32_t steps = 0;
+  for (int i = 0; i < pushes; i++) {
+    SokobanRules::Dir dir = pushPlanner.push(i);
+    int dx = SokobanRules::DIR_DX[dir];
+    int dy = SokobanRules::DIR_DY[dir];
+    int walk = pathFinder.findPath(
+      viewport.board, viewport.boardW, viewport.boardH, playerX, playerY, boxX - dx, boxY - dy);
+    if (walk < 0) {
+      break;
+    }
+#if SOKOBAN_GHOST
+    for (int s = 0; s < walk; s++) {
+      runLog.append(pathFinder.step(s));
+    }
+    runLog.append(dir);
+#endif
+    movePlayerTo(boxX - dx, boxY - dy);
+    removeBoxAt(boxX, boxY);
+    placeBoxAt(boxX + dx, boxY + dy);
+    movePlayerTo(boxX, boxY);
+    boxX += dx;
+    boxY += dy;
+    steps += (uint32_t)walk + 1u;
+    levelPushes++;
+  }
+
+  markCellDirty(startPlayerX, startPlayerY);
+  markCellDirty(selectedX, selectedY);
+  markCellDirty(playerX, playerY);
+  markCellDirty(boxX, boxY);
+  clearBoxSelection();
+  cursorActive = false;
+  markCursorDirty();
+  syncSpritesFromBoard();
+
+  levelMoves += steps;
+  totalMoves += steps;
+#if SOKOBAN_GHOST
+  advanceGhost();
+#endif
+  refreshHudTexts();
+  updateLevelSolvedState();
+  return true;
+}
+
+void SokobanGame::clearBoxSelection() {
+  if (boxSelected) {
+    markCellDirty(selectedX, selectedY);
   }
+  boxSelected = false;
+}
+
+void SokobanGame::movePlayerTo(int x, int y) {
+  clearPlayerAt(playerX, playerY);
+  placePlayerAt(x, y);
+  playerX = x;
+  playerY = y;
+}
+
+void SokobanGame::clearPlayerAt(int x, int y) {
+  viewport.board[y][x] = SokobanRules::withoutPlayer(viewport.board[y][x]);
 }
 
 void SokobanGame::placePlayerAt(int x, int y) {
-  char& cell = board[y][x];
-  if (cell == ' ') {
-    cell = '@';
-  } else if (cell == '.') {
-    cell = '+';
-  }
+  viewport.board[y][x] = SokobanRules::withPlayer(viewport.board[y][x]);
 }
 
 void SokobanGame::removeBoxAt(int x, int y) {
-  char& cell = board[y][x];
-  if (cell == '$') {
-    cell = ' ';
-  } else if (cell == '*') {
-    cell = '.';
+  char& cell = viewport.board[y][x];
+  if (cell == '*') {
     remainingCrates++;
   }
+  cell = SokobanRules::withoutBox(cell);
 }
 
 void SokobanGame::placeBoxAt(int x, int y) {
-  char& cell = board[y][x];
-  if (cell == ' ') {
-    cell = '$';
-  } else if (cell == '.') {
-    cell = '*';
+  char& cell = viewport.board[y][x];
+  if (cell == '.') {
     remainingCrates--;
   }
+  cell = SokobanRules::withBox(cell);
 }
 
 void SokobanGame::updateLevelSolvedState() {
   if (!levelSolved && remainingCrates == 0) {
     levelSolved = true;
     levelSolvedTimer = 0.0f;
+    // The only point where progress is written: once per solved level, never mid-play.
+    if (currentLevel < LEVEL_COUNT) {
+      progress.recordLevelSolved(currentLevel, levelMoves, levelPushes);
+      progress.flush();
+#if SOKOBAN_GHOST
+      MoveLog& best = bestRuns[currentLevel];
+      if (!runLog.truncated() && (best.length() == 0 || runLog.length() < best.length())) {
+        best = runLog;
+      }
+#endif
+    }
     refreshOverlayTexts();
     markOverlayDirty();
     refreshHudTexts();
@@ -417,65 +622,92 @@ void SokobanGame::updateLevelSolvedState() {
 }
 
 void SokobanGame::renderTitleScreen() {
-  const int titleScale = fitCenteredScale(renderTarget.width(), "UNOQ SOKOBAN", 4, 12);
+  waitForRenderIdle();
+  clearBoardGeometry();
+  screenshotSource = ScreenshotSource::None;
+#if SOKOBAN_TILE_SIGNATURES
+  tileSignatures.invalidateAll();
+#endif
+  const int titleScale = fitCenteredScale(screenW, "UNOQ SOKOBAN", 4, 12);
 
   dirty.clear();
-  screen.fillScreen565(COLOR_BG);
-  screen.fillRect565(14, 16, renderTarget.width() - 28, 4, COLOR_ACCENT);
-  screen.fillRect565(14, 24, renderTarget.width() - 28, 2, COLOR_PANEL_LINE);
-  screen.fillRect565(
-    14, renderTarget.height() - 26, renderTarget.width() - 28, 2, COLOR_PANEL_LINE);
-  screen.fillRect565(
-    14, renderTarget.height() - 18, renderTarget.width() - 28, 4, COLOR_ACCENT);
+  screen.fillScreen565(themeColors[Theme::BG]);
+  screen.fillRect565(14, 16, screenW - 28, 4, themeColors[Theme::ACCENT]);
+  screen.fillRect565(14, 24, screenW - 28, 2, themeColors[Theme::PANEL_LINE]);
+  screen.fillRect565(14, screenH - 26, screenW - 28, 2, themeColors[Theme::PANEL_LINE]);
+  screen.fillRect565(14, screenH - 18, screenW - 28, 4, themeColors[Theme::ACCENT]);
 
   Font5x7::drawCenteredText(
-    renderTarget.width(), 46, "UNOQ SOKOBAN", titleScale, COLOR_TEXT, &screen, fillRectOnDisplay);
+    screenW, 46, "UNOQ SOKOBAN", titleScale, themeColors[Theme::TEXT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 90, "10 PLANSZ", 2, COLOR_ACCENT, &screen, fillRectOnDisplay);
+    screenW, 90, "10 PLANSZ", 2, themeColors[Theme::ACCENT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 118, "L/R/U/D - RUCH", 2, COLOR_TEXT, &screen, fillRectOnDisplay);
+    screenW, 118, "L/R/U/D - RUCH", 2, themeColors[Theme::TEXT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 144, "FIRE - START", 2, COLOR_TEXT, &screen, fillRectOnDisplay);
+    screenW, 144, "FIRE - START", 2, themeColors[Theme::TEXT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 170, "FIRE W GRZE - RESTART", 1, COLOR_TEXT_DIM,
+    screenW, 170, "FIRE W GRZE - RESTART", 1, themeColors[Theme::TEXT_DIM],
     &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 194, "PRZENIES SKRZYNKI NA CELE", 1, COLOR_TEXT_DIM,
+    screenW, 182, "PRZYTRZYMAJ FIRE - IDZ DO", 1, themeColors[Theme::TEXT_DIM],
     &screen, fillRectOnDisplay);
+  Font5x7::drawCenteredText(
+    screenW, 194, "PRZENIES SKRZYNKI NA CELE", 1, themeColors[Theme::TEXT_DIM],
+    &screen, fillRectOnDisplay);
+  char themeBuf[24];
+  snprintf(themeBuf, sizeof(themeBuf), "L/R - MOTYW %s", Theme::name(theme));
+  Font5x7::drawCenteredText(
+    screenW, 206, themeBuf, 1, themeColors[Theme::ACCENT], &screen, fillRectOnDisplay);
+}
+
+void SokobanGame::setTheme(Theme::Id id) {
+  theme = id;
+  themeColors = Theme::palette(id);
 }
 
 void SokobanGame::renderGameOverScreen() {
+  waitForRenderIdle();
+  clearBoardGeometry();
+  screenshotSource = ScreenshotSource::None;
+#if SOKOBAN_TILE_SIGNATURES
+  tileSignatures.invalidateAll();
+#endif
   dirty.clear();
   char movesBuf[24];
   char levelsBuf[24];
-  const int titleScale = fitCenteredScale(renderTarget.width(), "GAME OVER", 4, 12);
+  const int titleScale = fitCenteredScale(screenW, "GAME OVER", 4, 12);
   snprintf(movesBuf, sizeof(movesBuf), "%lu", (unsigned long)finalMoves);
   snprintf(levelsBuf, sizeof(levelsBuf), "%u / %u", (unsigned)LEVEL_COUNT, (unsigned)LEVEL_COUNT);
 
-  screen.fillScreen565(COLOR_GO_BG);
-  screen.fillRect565(18, 18, renderTarget.width() - 36, 3, COLOR_GO_LINE);
-  screen.fillRect565(18, renderTarget.height() - 21, renderTarget.width() - 36, 3, COLOR_GO_LINE);
+  screen.fillScreen565(themeColors[Theme::GO_BG]);
+  screen.fillRect565(18, 18, screenW - 36, 3, themeColors[Theme::GO_LINE]);
+  screen.fillRect565(18, screenH - 21, screenW - 36, 3, themeColors[Theme::GO_LINE]);
 
   Font5x7::drawCenteredText(
-    renderTarget.width(), 48, "GAME OVER", titleScale, COLOR_GO_TITLE, &screen, fillRectOnDisplay);
+    screenW, 48, "GAME OVER", titleScale, themeColors[Theme::GO_TITLE], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 96, "UKONCZONE PLANSZE", 1, COLOR_TEXT_DIM,
+    screenW, 96, "UKONCZONE PLANSZE", 1, themeColors[Theme::TEXT_DIM],
     &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 112, levelsBuf, 3, COLOR_TEXT, &screen, fillRectOnDisplay);
+    screenW, 112, levelsBuf, 3, themeColors[Theme::TEXT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 152, "RUCHY", 1, COLOR_TEXT_DIM, &screen, fillRectOnDisplay);
+    screenW, 152, "RUCHY", 1, themeColors[Theme::TEXT_DIM], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 168, movesBuf, 3, COLOR_ACCENT, &screen, fillRectOnDisplay);
+    screenW, 168, movesBuf, 3, themeColors[Theme::ACCENT], &screen, fillRectOnDisplay);
   Font5x7::drawCenteredText(
-    renderTarget.width(), 206, "FIRE - MENU", 2, COLOR_TEXT, &screen, fillRectOnDisplay);
+    screenW, 206, "FIRE - MENU", 2, themeColors[Theme::TEXT], &screen, fillRectOnDisplay);
 }
 
 void SokobanGame::refreshHudTexts() {
   char buf[24];
   bool changed = false;
 
-  snprintf(buf, sizeof(buf), "LVL %u/%u", (unsigned)(currentLevel + 1), (unsigned)LEVEL_COUNT);
+  if (currentLevel < LEVEL_COUNT) {
+    snprintf(
+      buf, sizeof(buf), "LVL %u/%u", (unsigned)(currentLevel + 1), (unsigned)LEVEL_COUNT);
+  } else {
+    snprintf(buf, sizeof(buf), "LVL %u", (unsigned)(currentLevel + 1));
+  }
   if (strcmp(hudLevelText, buf) != 0) {
     strncpy(hudLevelText, buf, sizeof(hudLevelText) - 1);
     hudLevelText[sizeof(hudLevelText) - 1] = '\0';
@@ -496,7 +728,14 @@ void SokobanGame::refreshHudTexts() {
     changed = true;
   }
 
-  const char* status = levelSolved ? "OK" : "FIRE=RESET";
+  const char* status = "FIRE=RESET";
+  if (levelSolved) {
+    status = "OK";
+  } else if (boxSelected) {
+    status = "FIRE=PUSH";
+  } else if (cursorActive) {
+    status = "FIRE=GO";
+  }
   if (strcmp(hudStatusText, status) != 0) {
     strncpy(hudStatusText, status, sizeof(hudStatusText) - 1);
     hudStatusText[sizeof(hudStatusText) - 1] = '\0';
@@ -509,6 +748,176 @@ void SokobanGame::refreshHudTexts() {
   }
 }
 
+void SokobanGame::cacheParGlyphs() {
+  // The par only changes with the level, so its glyphs are looked up once here and the HUD
+  // copies mask bits instead.
+  memset(hudParMask, 0, sizeof(hudParMask));
+  hudParW = 0;
+  if (parMoves != 0) {
+    char text[PAR_TEXT_MAX + 1];
+    snprintf(text, sizeof(text), "PAR %u", (unsigned)parMoves);
+    hudParW = Font5x7::textWidth(text, 1);
+    for (int y = 0; y < PAR_MASK_ROWS; y++) {
+      for (int x = 0; x < hudParW; x++) {
+        if (Font5x7::textPixel(text, 1, x, y)) {
+          hudParMask[y][x >> 3] |= (uint8_t)(1u << (x & 7));
+        }
+      }
+    }
+  }
+  updateHudLayout();
+}
+
+void SokobanGame::cacheTimerGlyphs() {
+  static constexpr char GLYPHS[TIMER_GLYPH_COUNT + 1] = "0123456789:.";
+  for (int g = 0; g < TIMER_GLYPH_COUNT; g++) {
+    const char text[2] = {GLYPHS[g], '\0'};
+    for (int y = 0; y < TIMER_GLYPH_ROWS; y++) {
+      uint8_t bits = 0;
+      for (int x = 0; x < TIMER_CELL_W - 1; x++) {
+        if (Font5x7::textPixel(text, 1, x, y)) {
+          bits |= (uint8_t)(1u << x);
+        }
+      }
+      timerGlyphs[g][y] = bits;
+    }
+  }
+}
+
+void SokobanGame::resetLevelTimer() {
+  // Called before the level's full repaint, which draws the whole field.
+  levelTimeUs = 0;
+  levelTimeTenths = 0;
+  memcpy(hudTimerText, "00:00.0", sizeof(hudTimerText));
+}
+
+void SokobanGame::advanceLevelTimer(float delta) {
+  const uint32_t tenths = advanceTimerUs(levelTimeUs, delta);
+  if (tenths == levelTimeTenths) {
+    return;
+  }
+  levelTimeTenths = tenths;
+
+  const uint32_t seconds = tenths / 10u;
+  const char text[TIMER_CHARS] = {
+    (char)('0' + seconds / 600u),
+    (char)('0' + seconds / 60u % 10u),
+    ':',
+    (char)('0' + seconds % 60u / 10u),
+    (char)('0' + seconds % 10u),
+    '.',
+    (char)('0' + tenths % 10u),
+  };
+  // Most ticks change only the tenths digit: one 5x7 cell instead of the whole HUD strip.
+  for (int i = 0; i < TIMER_CHARS; i++) {
+    if (hudTimerText[i] != text[i]) {
+      hudTimerText[i] = text[i];
+      markRectDirty(hudTimerX + i * TIMER_CELL_W, HUD_TIMER_Y, TIMER_CELL_W - 1, TIMER_GLYPH_ROWS);
+    }
+  }
+}
+
+#if SOKOBAN_TARGET_PULSE
+void SokobanGame::resetTargetPulse() {
+  targetFrame = 0;
+  pulseFrameS = 0.0f;
+  viewport.targetRing = &targetRings[0];
+}
+
+void SokobanGame::advanceTargetPulse(float delta) {
+  // The budget refills at the cap and holds one frame's share of it, so no window of T
+  // seconds sees more than (T + PULSE_FRAME_S) * cap. Bytes the render side pushed for
+  // earlier ticks are taken out as they are reported; a board whose tick costs more than
+  // one share stays static.
+  constexpr float BUDGET_MAX_BYTES = PULSE_MAX_BYTES_PER_S * PULSE_FRAME_S;
+  const uint32_t pushed = pulsePushedBytes.load(std::memory_order_relaxed);
+  pulseBudgetBytes -= (float)(pushed - pulseChargedBytes);
+  pulseChargedBytes = pushed;
+  pulseBudgetBytes += delta * PULSE_MAX_BYTES_PER_S;
+  if (pulseBudgetBytes > BUDGET_MAX_BYTES) {
+    pulseBudgetBytes = BUDGET_MAX_BYTES;
+  }
+
+  pulseFrameS += delta;
+  if (pulseFrameS < PULSE_FRAME_S || levelSolved) {
+    return;
+  }
+#if SOKOBAN_BUDGETED_FLUSH
+  if (repaint.active()) {
+    return;
+  }
+#endif
+  if (levelMoves != pulseMovesSeen) {
+    // A move is in this frame's flush; the tick rides with the next one instead.
+    pulseMovesSeen = levelMoves;
+    return;
+  }
+
+  // Every frame's marker lies within the static ring's box, clipped to the cell inside its
+  // grid line; only that box of each uncovered target is repainted.
+  const int tile = viewport.tileSize;
+  const int c = tile / 2;
+  const int reach = targetRings[0].reach;
+  const int lx0 = (c - reach > 1) ? c - reach : 1;
+  const int lx1 = (c + reach + 1 < tile) ? c + reach + 1 : tile;
+  int targets = 0;
+  for (int y = 0; y < viewport.boardH; y++) {
+    for (int x = 0; x < viewport.boardW; x++) {
+      char cell = viewport.board[y][x];
+      targets += (cell == '.' || cell == '+') ? 1 : 0;
+    }
+  }
+  const float estimate = (float)(targets * (lx1 - lx0) * (lx1 - lx0) * 2);
+  if (targets == 0 || estimate > pulseBudgetBytes) {
+    return;
+  }
+
+  pulseFrameS = 0.0f;
+  targetFrame = (uint8_t)((targetFrame + 1) % TARGET_RING_FRAMES);
+  viewport.targetRing = &targetRings[targetFrame];
+  pulseTicks++;
+  for (int y = 0; y < viewport.boardH; y++) {
+    for (int x = 0; x < viewport.boardW; x++) {
+      char cell = viewport.board[y][x];
+      if (cell == '.' || cell == '+') {
+        markRectDirty(
+          viewport.cellX(x) + lx0, viewport.cellY(y) + lx0, lx1 - lx0, lx1 - lx0);
+      }
+    }
+  }
+}
+
+void SokobanGame::notePulseFlush(const PlayfieldView& view, uint32_t pixels) {
+  // The whole flush is charged, including anything that rode along with the tick, so the
+  // cap is an upper bound on the pulse's own bytes.
+  if (view.pulseTicks == pulseRenderedTicks) {
+    return;
+  }
+  pulseRenderedTicks = view.pulseTicks;
+  const uint32_t bytes = pixels * 2u;
+  pulsePushedBytes.fetch_add(bytes, std::memory_order_relaxed);
+#if SOKOBAN_RENDER_STATS
+  pulseWindowBytes += bytes;
+  const uint32_t nowUs = micros();
+  if (pulseWindowStartUs == 0) {
+    pulseWindowStartUs = nowUs;
+  }
+  const uint32_t windowUs = nowUs - pulseWindowStartUs;
+  if (windowUs >= 1000000u) {
+    Serial.print("[pulse] pushed ");
+    Serial.print((unsigned long)pulseWindowBytes);
+    Serial.print(" B in ");
+    Serial.print((unsigned long)(windowUs / 1000u));
+    Serial.print(" ms, cap ");
+    Serial.print((unsigned long)PULSE_MAX_BYTES_PER_S);
+    Serial.println(" B/s");
+    pulseWindowStartUs = nowUs;
+    pulseWindowBytes = 0;
+  }
+#endif
+}
+#endif
+
 void SokobanGame::refreshOverlayTexts() {
   overlayTitleText[0] = '\0';
   overlaySubText[0] = '\0';
@@ -521,7 +930,7 @@ void SokobanGame::refreshOverlayTexts() {
            sizeof(overlayTitleText),
            "PLANSZA %u OK",
            (unsigned)(currentLevel + 1));
-  if (currentLevel + 1 < LEVEL_COUNT) {
+  if (currentLevel + 1 < LEVEL_COUNT || SOKOBAN_ENDLESS) {
     strncpy(overlaySubText, "KOLEJNA ZA CHWILE", sizeof(overlaySubText) - 1);
   } else {
     strncpy(overlaySubText, "KONIEC GRY", sizeof(overlaySubText) - 1);
@@ -532,34 +941,13 @@ void SokobanGame::refreshOverlayTexts() {
 }
 
 void SokobanGame::updateBoardLayout() {
-  int maxTileW = (renderTarget.width() - 8) / boardW;
-  int maxTileH = (renderTarget.height() - HUD_H - 8) / boardH;
-  tileSize = maxTileW;
-  if (maxTileH < tileSize) {
-    tileSize = maxTileH;
-  }
-  if (tileSize > MAX_TILE_SIZE) {
-    tileSize = MAX_TILE_SIZE;
-  }
-  if (tileSize < SPRITE_SIZE) {
-    tileSize = SPRITE_SIZE;
-  }
-
-  boardX0 = (renderTarget.width() - boardPixelWidth()) / 2;
-  if (boardX0 < 4) {
-    boardX0 = 4;
-  }
-
-  int contentTop = HUD_H + 4;
-  int contentH = renderTarget.height() - contentTop - 4;
-  boardY0 = contentTop + (contentH - boardPixelHeight()) / 2;
-  if (boardY0 < contentTop) {
-    boardY0 = contentTop;
-  }
+  viewport.fit(0, HUD_H, screenW, screenH - HUD_H, SPRITE_SIZE, MAX_TILE_SIZE);
+  bindSpriteArt(viewport.tileSize);
+  bindTargetRings(viewport.tileSize);
+  viewport.targetRing = &targetRings[0];
 }
 
 void SokobanGame::updateHudLayout() {
-  const int screenW = renderTarget.width();
   hudTitleX = 8;
   hudLevelX = screenW - Font5x7::textWidth(hudLevelText, 2) - 8;
   if (hudLevelX < hudTitleX + Font5x7::textWidth("SOKOBAN", 2) + 8) {
@@ -567,9 +955,12 @@ void SokobanGame::updateHudLayout() {
   }
 
   hudMovesX = 8;
+  hudTimerX = hudMovesX;
+  hudParX = hudMovesX + Font5x7::textWidth(hudMovesText, 1) + 6;
+  int movesRight = (hudParW > 0) ? hudParX + hudParW : hudParX - 6;
   hudTotalX = (screenW - Font5x7::textWidth(hudTotalText, 1)) / 2;
-  if (hudTotalX < hudMovesX + Font5x7::textWidth(hudMovesText, 1) + 8) {
-    hudTotalX = hudMovesX + Font5x7::textWidth(hudMovesText, 1) + 8;
+  if (hudTotalX < movesRight + 8) {
+    hudTotalX = movesRight + 8;
   }
 
   hudStatusX = screenW - Font5x7::textWidth(hudStatusText, 1) - 8;
@@ -589,18 +980,18 @@ void SokobanGame::updateOverlayLayout() {
   if (overlayW < 160) {
     overlayW = 160;
   }
-  if (overlayW > renderTarget.width() - 16) {
-    overlayW = renderTarget.width() - 16;
+  if (overlayW > screenW - 16) {
+    overlayW = screenW - 16;
   }
 
-  overlayX0 = (renderTarget.width() - overlayW) / 2;
-  overlayY0 = (renderTarget.height() - OVERLAY_H) / 2;
-  overlayTitleX = (renderTarget.width() - Font5x7::textWidth(overlayTitleText, 2)) / 2;
-  overlaySubX = (renderTarget.width() - Font5x7::textWidth(overlaySubText, 1)) / 2;
+  overlayX0 = (screenW - overlayW) / 2;
+  overlayY0 = (screenH - OVERLAY_H) / 2;
+  overlayTitleX = (screenW - Font5x7::textWidth(overlayTitleText, 2)) / 2;
+  overlaySubX = (screenW - Font5x7::textWidth(overlaySubText, 1)) / 2;
 }
 
 void SokobanGame::markHudDirty() {
-  markRectDirty(0, 0, renderTarget.width(), HUD_H);
+  markRectDirty(0, 0, screenW, HUD_H);
 }
 
 void SokobanGame::markOverlayDirty() {
@@ -608,17 +999,21 @@ void SokobanGame::markOverlayDirty() {
 }
 
 void SokobanGame::markCellDirty(int gx, int gy) {
-  if (!inBounds(gx, gy)) {
+  if (!viewport.inBounds(gx, gy)) {
     return;
   }
-  markRectDirty(boardX0 + gx * tileSize, boardY0 + gy * tileSize, tileSize, tileSize);
+  markRectDirty(viewport.cellX(gx), viewport.cellY(gy), viewport.tileSize, viewport.tileSize);
+}
+
+void SokobanGame::markCursorDirty() {
+  markCellDirty(cursorX, cursorY);
 }
 
 void SokobanGame::markBoardFrameDirty() {
-  int x = boardX0 - 2;
-  int y = boardY0 - 2;
-  int w = boardPixelWidth() + 4;
-  int h = boardPixelHeight() + 4;
+  int x = viewport.boardX0 - BoardViewport::FRAME;
+  int y = viewport.boardY0 - BoardViewport::FRAME;
+  int w = viewport.pixelWidth() + 2 * BoardViewport::FRAME;
+  int h = viewport.pixelHeight() + 2 * BoardViewport::FRAME;
   markRectDirty(x, y, w, h);
 }
 
@@ -626,321 +1021,664 @@ void SokobanGame::markRectDirty(int x, int y, int w, int h) {
   if (w <= 0 || h <= 0) {
     return;
   }
-  dirty.add(x, y, x + w - 1, y + h - 1);
-}
-
-void SokobanGame::invalidatePlayingScreen() {
-  dirty.invalidate(renderTarget);
+#if SOKOBAN_TILE_SIGNATURES
+  TileSignatureCache::snapToCells(x, y, w, h);
+#endif
+#if SOKOBAN_DUAL_CORE
+  if (renderTaskOwnsDisplay) {
+    renderQueue.markDirty(x, y, x + w - 1, y + h - 1);
+    return;
+  }
+#endif
+  addDirtyRect(x, y, x + w - 1, y + h - 1);
 }
 
-void SokobanGame::flushDirty() {
-  flusher.flush(renderTarget, regionBuf, [this](int x0, int y0, int w, int h, uint16_t* buf) {
-    renderRegionToBuffer(x0, y0, w, h, buf);
+void SokobanGame::addDirtyRect(int x0, int y0, int x1, int y1) {
+#if SOKOBAN_GRID_FLUSH
+  dirtyCells.add(x0, y0, x1, y1, [this](int ox0, int oy0, int ox1, int oy1) {
+    dirty.add(ox0, oy0, ox1, oy1);
   });
+#else
+  dirty.add(x0, y0, x1, y1);
+#endif
 }
 
-void SokobanGame::buildSpritePixels() {
-  memset(boxSpritePixels, 0, sizeof(boxSpritePixels));
-  memset(playerSpritePixels, 0, sizeof(playerSpritePixels));
-
-  auto put = [](uint16_t* dst, int size, int x, int y, uint16_t c) {
-    if (x < 0 || y < 0 || x >= size || y >= size) {
-      return;
-    }
-    dst[y * size + x] = c;
-  };
+void SokobanGame::invalidateDirty() {
+#if SOKOBAN_GRID_FLUSH
+  addDirtyRect(0, 0, screenW - 1, screenH - 1);
+#else
+  dirty.invalidate(renderTarget);
+#endif
+}
 
-  for (int y = 2; y <= 13; y++) {
-    for (int x = 2; x <= 13; x++) {
-      uint16_t c = COLOR_BOX;
-      if (y <= 3 || x <= 3) {
-        c = COLOR_BOX_HI;
-      } else if (y >= 12 || x >= 12) {
-        c = COLOR_BOX_SH;
-      }
-      put(boxSpritePixels, SPRITE_SIZE, x, y, c);
-    }
-  }
-  for (int y = 5; y <= 10; y++) {
-    put(boxSpritePixels, SPRITE_SIZE, 7, y, COLOR_BOX_SH);
-    put(boxSpritePixels, SPRITE_SIZE, 8, y, COLOR_BOX_SH);
-  }
-  for (int x = 5; x <= 10; x++) {
-    put(boxSpritePixels, SPRITE_SIZE, x, 7, COLOR_BOX_SH);
-    put(boxSpritePixels, SPRITE_SIZE, x, 8, COLOR_BOX_SH);
-  }
-
-  for (int y = 1; y <= 15; y++) {
-    for (int x = 1; x <= 14; x++) {
-      bool paint = false;
-      uint16_t c = 0;
-      if (y >= 1 && y <= 5 && x >= 5 && x <= 10) {
-        paint = true;
-        c = (y <= 2 || x <= 5) ? COLOR_PLAYER_HI : COLOR_PLAYER;
-      } else if (y >= 6 && y <= 11 && x >= 4 && x <= 11) {
-        paint = true;
-        c = (x <= 5 || y <= 7) ? COLOR_PLAYER_HI : COLOR_PLAYER;
-      } else if (y >= 12 && y <= 15 && ((x >= 3 && x <= 6) || (x >= 9 && x <= 12))) {
-        paint = true;
-        c = COLOR_PLAYER_SH;
-      }
-      if (paint) {
-        put(playerSpritePixels, SPRITE_SIZE, x, y - 1, c);
-      }
-    }
-  }
+void SokobanGame::clearBoardGeometry() {
+#if SOKOBAN_GRID_FLUSH
+  dirtyCells.setBoard(0, 0, 0, 0, 0, MAX_TILE_W * MAX_TILE_H);
+#endif
 }
 
-void SokobanGame::initSpriteSlots() {
-  sprites.clearAll();
-  for (int i = 0; i < BOX_SPRITE_SLOT_COUNT; i++) {
-    auto& s = sprites.sprite(i);
-    s.active = false;
-    s.w = SPRITE_SIZE;
-    s.h = SPRITE_SIZE;
-    s.pixels565 = boxSpritePixels;
-    s.transparent = 0;
-    s.scale = SpriteLayer::Scale::Normal;
-    s.setAnchor(0.0f, 0.0f);
-  }
-
-  auto& p = sprites.sprite(PLAYER_SPRITE_SLOT);
-  p.active = false;
-  p.w = SPRITE_SIZE;
-  p.h = SPRITE_SIZE;
-  p.pixels565 = playerSpritePixels;
-  p.transparent = 0;
-  p.scale = SpriteLayer::Scale::Normal;
-  p.setAnchor(0.0f, 0.0f);
+void SokobanGame::invalidatePlayingScreen() {
+#if SOKOBAN_DUAL_CORE
+  if (renderTaskOwnsDisplay) {
+    renderQueue.markAll();
+    return;
+  }
+#endif
+#if SOKOBAN_GRID_FLUSH
+  // The board layout only changes on the way here.
+  dirtyCells.setBoard(viewport.boardX0,
+                      viewport.boardY0,
+                      viewport.boardW,
+                      viewport.boardH,
+                      viewport.tileSize,
+                      MAX_TILE_W * MAX_TILE_H);
+#endif
+#if SOKOBAN_BUDGETED_FLUSH
+  repaint.begin(RepaintSchedule::Layout{screenW,
+                                        screenH,
+                                        HUD_H,
+                                        viewport.boardX0,
+                                        viewport.boardY0,
+                                        viewport.boardW,
+                                        viewport.boardH,
+                                        viewport.tileSize,
+                                        playerX,
+                                        playerY});
+#else
+  invalidateDirty();
+#endif
 }
 
-void SokobanGame::syncSpritesFromBoard() {
-  for (int i = 0; i < BOX_SPRITE_SLOT_COUNT; i++) {
-    sprites.sprite(i).active = false;
+void SokobanGame::flushDirty() {
+#if SOKOBAN_DUAL_CORE
+  publishFrame();
+#else
+  captureView(frontView);
+#if SOKOBAN_LATENCY_PROBE
+  latencyEdgeUs = 0;
+#endif
+#if SOKOBAN_BUDGETED_FLUSH
+  if (repaint.active()) {
+    flushRepaintSlice();
+    return;
   }
+#endif
+  renderView(frontView);
+#endif
+}
 
-  int slot = 0;
-  for (int y = 0; y < boardH; y++) {
-    for (int x = 0; x < boardW; x++) {
-      if (!isBox(board[y][x])) {
-        continue;
-      }
-      if (slot >= BOX_SPRITE_SLOT_COUNT) {
-        continue;
-      }
-      auto& s = sprites.sprite(slot++);
-      s.active = true;
-      s.setPosition(boardX0 + x * tileSize + spriteInset(), boardY0 + y * tileSize + spriteInset());
+#if SOKOBAN_BUDGETED_FLUSH
+void SokobanGame::flushRepaintSlice() {
+  // Rects marked by this frame's moves ride along with the first chunk. A chunk is rendered
+  // from the current view, so cells that changed before their turn come out up to date.
+  uint32_t startUs = micros();
+  int x = 0;
+  int y = 0;
+  int w = 0;
+  int h = 0;
+  while (repaint.next(x, y, w, h)) {
+    markRectDirty(x, y, w, h);
+    renderView(frontView);
+    if (micros() - startUs >= FLUSH_BUDGET_US) {
+      break;
     }
   }
+}
+#endif
+
+void SokobanGame::captureView(PlayfieldView& view) const {
+  view.viewport = viewport;
+  view.screenW = screenW;
+  view.screenH = screenH;
+  memcpy(view.spriteSlots, spriteSlots, sizeof(view.spriteSlots));
+  view.spriteSize = spriteSize;
+  view.boxSpritePixels = boxSpritePixels;
+  view.playerSpritePixels = playerSpritePixels;
+#if SOKOBAN_GHOST
+  view.ghostSpritePixels = ghostSpritePixels;
+#endif
+  view.colors = themeColors;
+  view.cursorActive = cursorActive;
+  view.cursorX = cursorX;
+  view.cursorY = cursorY;
+  view.boxSelected = boxSelected;
+  view.selectedX = selectedX;
+  view.selectedY = selectedY;
+  view.levelSolved = levelSolved;
+  memcpy(view.hudLevelText, hudLevelText, sizeof(view.hudLevelText));
+  memcpy(view.hudMovesText, hudMovesText, sizeof(view.hudMovesText));
+  memcpy(view.hudTotalText, hudTotalText, sizeof(view.hudTotalText));
+  memcpy(view.hudStatusText, hudStatusText, sizeof(view.hudStatusText));
+  view.hudTitleX = hudTitleX;
+  view.hudLevelX = hudLevelX;
+  view.hudMovesX = hudMovesX;
+  view.hudTotalX = hudTotalX;
+  view.hudStatusX = hudStatusX;
+  memcpy(view.hudParMask, hudParMask, sizeof(view.hudParMask));
+  view.hudParX = hudParX;
+  view.hudParW = hudParW;
+  memcpy(view.hudTimerText, hudTimerText, sizeof(view.hudTimerText));
+  view.hudTimerX = hudTimerX;
+  view.timerGlyphs = timerGlyphs;
+  memcpy(view.overlayTitleText, overlayTitleText, sizeof(view.overlayTitleText));
+  memcpy(view.overlaySubText, overlaySubText, sizeof(view.overlaySubText));
+  view.overlayX0 = overlayX0;
+  view.overlayY0 = overlayY0;
+  view.overlayW = overlayW;
+  view.overlayTitleX = overlayTitleX;
+  view.overlaySubX = overlaySubX;
+#if SOKOBAN_LATENCY_PROBE
+  view.latencyEdgeUs = latencyEdgeUs;
+#endif
+#if SOKOBAN_TARGET_PULSE
+  view.pulseTicks = pulseTicks;
+#endif
+}
 
-  auto& p = sprites.sprite(PLAYER_SPRITE_SLOT);
-  p.active = true;
-  p.setPosition(
-    boardX0 + playerX * tileSize + spriteInset(),
-    boardY0 + playerY * tileSize + spriteInset());
+void SokobanGame::renderView(const PlayfieldView& view) {
+  applySpriteSlots(view);
+  // Pixels handed to the flush target; with tile signatures the panel may get fewer.
+  uint32_t pixels = 0;
+  flusher.flush(flushTarget(),
+                regionBuf,
+                [this, &view, &pixels](int x0, int y0, int w, int h, uint16_t* buf) {
+                  (view.*regionRenderer)(sprites, x0, y0, w, h, buf);
+                  pixels += (uint32_t)(w * h);
+                });
+#if SOKOBAN_GRID_FLUSH
+  dirtyCells.flush([this, &view, &pixels](int x0, int y0, int w, int h) {
+    (view.*regionRenderer)(sprites, x0, y0, w, h, regionBuf);
+    flushTarget().drawRGB565(x0, y0, w, h, regionBuf);
+    pixels += (uint32_t)(w * h);
+  });
+#endif
+  finishFlush();
+#if SOKOBAN_TARGET_PULSE
+  notePulseFlush(view, pixels);
+#else
+  (void)pixels;
+#endif
+#if SOKOBAN_LATENCY_PROBE
+  if (view.latencyEdgeUs != 0 && latencyProbe.record(view.latencyEdgeUs, micros())) {
+    reportLatency();
+  }
+#endif
 }
 
-int SokobanGame::boardPixelWidth() const {
-  return boardW * tileSize;
+IRenderTarget& SokobanGame::flushTarget() {
+#if SOKOBAN_TILE_SIGNATURES
+  return tileSignatures;
+#else
+  return renderTarget;
+#endif
 }
 
-int SokobanGame::boardPixelHeight() const {
-  return boardH * tileSize;
+void SokobanGame::finishFlush() {
+#if SOKOBAN_TILE_SIGNATURES
+  tileSignatures.endFrame();
+#if SOKOBAN_RENDER_STATS
+  if (tileSignatures.lastPushedBytes() != 0 || tileSignatures.lastSkippedBytes() != 0) {
+    Serial.print("[render] flush pushed ");
+    Serial.print((unsigned long)tileSignatures.lastPushedBytes());
+    Serial.print(" B, skipped ");
+    Serial.print((unsigned long)tileSignatures.lastSkippedBytes());
+    Serial.print(" B, total skipped ");
+    Serial.println((unsigned long)tileSignatures.totalSkippedBytes());
+  }
+#endif
+#endif
 }
 
-int SokobanGame::spriteInset() const {
-  int inset = (tileSize - SPRITE_SIZE) / 2;
-  if (inset < 0) {
-    return 0;
+#if SOKOBAN_LATENCY_PROBE
+void SokobanGame::reportLatency() {
+  // Printed by the side that renders, like the other render stats; the panel size and SPI
+  // clock tell hardware profiles apart in a log.
+  Serial.print("[latency] ");
+  Serial.print(screenW);
+  Serial.print("x");
+  Serial.print(screenH);
+  Serial.print(" SPI ");
+  Serial.print((unsigned long)(hardwareProfile.display.spiHz / 1000u));
+  Serial.print(" kHz: n ");
+  Serial.print((unsigned long)latencyProbe.samples());
+  Serial.print(" min ");
+  Serial.print((unsigned long)latencyProbe.minUs());
+  Serial.print(" mean ");
+  Serial.print((unsigned long)latencyProbe.meanUs());
+  Serial.print(" max ");
+  Serial.print((unsigned long)latencyProbe.maxUs());
+  Serial.println(" us");
+  Serial.print("[latency]");
+  for (int i = 0; i < LatencyProbe::BUCKETS; i++) {
+    uint32_t limit = LatencyProbe::bucketLimitUs(i);
+    if (limit != 0) {
+      Serial.print(" <");
+      Serial.print((unsigned long)(limit / 1000u));
+    } else {
+      Serial.print(" >=");
+      Serial.print((unsigned long)(LatencyProbe::bucketLimitUs(i - 1) / 1000u));
+    }
+    Serial.print("ms ");
+    Serial.print((unsigned long)latencyProbe.bucketCount(i));
+  }
+  Serial.println();
+}
+#endif
+
+void SokobanGame::applySpriteSlots(const PlayfieldView& view) {
+  // Sprites are always `tileSize` square here (see `updateBoardLayout()`), so the grid's cell
+  // size is the board's.
+  sprites.setGeometry(view.viewport.boardX0, view.viewport.boardY0, view.spriteSize);
+  sprites.setPalette(view.colors);
+  for (int i = 0; i < SpriteGrid::MAX_SPRITES; i++) {
+    const SpriteSlot& slot = view.spriteSlots[i];
+    if (!slot.active) {
+      sprites.hide(i);
+      continue;
+    }
+    const uint8_t* pixels =
+      (i == PLAYER_SPRITE_SLOT) ? view.playerSpritePixels : view.boxSpritePixels;
+#if SOKOBAN_GHOST
+    pixels = (i == GHOST_SPRITE_SLOT) ? view.ghostSpritePixels : pixels;
+#endif
+    sprites.setPosition(i, slot.x, slot.y, pixels);
   }
-  return inset;
 }
 
-uint16_t SokobanGame::pixelAt(int x, int y) const {
-  if (x < 0 || x >= renderTarget.width() || y < 0 || y >= renderTarget.height()) {
-    return COLOR_BG;
+void SokobanGame::waitForRenderIdle() {
+#if SOKOBAN_DUAL_CORE
+  if (!renderTaskOwnsDisplay) {
+    return;
   }
-  if (y < HUD_H) {
-    return hudPixelAt(x, y);
+  while (!renderQueue.drained()) {
+    RenderTask::pause();
   }
-  return boardPixelAt(x, y);
+  renderTaskOwnsDisplay = false;
+#endif
 }
 
-uint16_t SokobanGame::hudPixelAt(int x, int y) const {
-  if (y < 0 || y >= HUD_H) {
-    return 0;
+#if SOKOBAN_SCREENSHOT
+void SokobanGame::pollDebugCommands() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c == 'S' || c == 's') {
+      streamScreenshot(Serial);
+    }
   }
+}
 
-  if (y >= HUD_H - 2) {
-    return COLOR_PANEL_LINE;
+void SokobanGame::streamScreenshot(Print& out) {
+  // The screen is re-rendered from the same state the panel was last drawn from, so the
+  // render task has to finish first. Row 0 of `regionBuf` holds the last row of the previous
+  // strip, which the encoder needs for its copy-from-above packets.
+  waitForRenderIdle();
+  const PlayfieldView* view = nullptr;
+  if (screenshotSource == ScreenshotSource::Playfield) {
+#if SOKOBAN_DUAL_CORE
+    const auto* frame = renderQueue.lastRendered();
+    view = (frame != nullptr) ? &frame->view : nullptr;
+#else
+    view = &frontView;
+#endif
+  }
+  if (screenshotSource == ScreenshotSource::None ||
+      (screenshotSource == ScreenshotSource::Playfield && view == nullptr)) {
+    out.print("SOKOBAN-SHOT ERR screen is not re-renderable\n");
+    return;
   }
-
-  uint16_t color = COLOR_PANEL;
-  int ly = 0;
-  int lx = 0;
-
-  ly = y - HUD_TITLE_Y;
-  lx = x - hudTitleX;
-  if (Font5x7::textPixel("SOKOBAN", 2, lx, ly)) {
-    return COLOR_ACCENT;
+  if (view != nullptr) {
+    applySpriteSlots(*view);
+  }
+
+  const int stripRows = MAX_TILE_W * MAX_TILE_H / screenW - 1;
+  uint16_t* strip = regionBuf + screenW;
+  ScreenshotStream stream(out);
+  stream.begin(screenW, screenH);
+  for (int y0 = 0; y0 < screenH; y0 += stripRows) {
+    const int rows = (y0 + stripRows <= screenH) ? stripRows : screenH - y0;
+    if (view != nullptr) {
+      (view->*regionRenderer)(sprites, 0, y0, screenW, rows, strip);
+#if SOKOBAN_RACE
+    } else if (screenshotSource == ScreenshotSource::Race) {
+      raceScene.renderRegion(0, y0, screenW, rows, strip);
+#endif
+    } else {
+      levelSelectScene.renderRegion(0, y0, screenW, rows, strip);
+    }
+    for (int r = 0; r < rows; r++) {
+      const uint16_t* row = strip + r * screenW;
+      stream.writeRow(row, (y0 + r == 0) ? nullptr : row - screenW);
+    }
+    memcpy(regionBuf, strip + (rows - 1) * screenW, (size_t)screenW * sizeof(uint16_t));
   }
+  stream.end();
+}
+#endif
 
-  ly = y - HUD_LEVEL_Y;
-  lx = x - hudLevelX;
-  if (Font5x7::textPixel(hudLevelText, 2, lx, ly)) {
-    return COLOR_TEXT;
+#if SOKOBAN_DUAL_CORE
+void SokobanGame::publishFrame() {
+  if (!renderTaskOwnsDisplay) {
+    // Rects marked while the logic loop drew are still in `dirty`, which the render task
+    // flushes with its first frame; the full repaint just makes sure that frame exists.
+    renderTaskOwnsDisplay = true;
+    renderQueue.markAll();
   }
-
-  ly = y - HUD_MOVES_Y;
-  lx = x - hudMovesX;
-  if (Font5x7::textPixel(hudMovesText, 1, lx, ly)) {
-    return COLOR_TEXT;
+  if (!renderQueue.publish([this](PlayfieldView& view) { captureView(view); })) {
+    return;
   }
-
-  ly = y - HUD_TOTAL_Y;
-  lx = x - hudTotalX;
-  if (Font5x7::textPixel(hudTotalText, 1, lx, ly)) {
-    return COLOR_TEXT;
+#if SOKOBAN_LATENCY_PROBE
+  // A frame the render side skips takes its stamp with it; that sample is lost.
+  latencyEdgeUs = 0;
+#endif
+  if (!renderTaskStarted) {
+    // No second core available: draw the frame inline, as the single-core build does.
+    renderNextFrame();
   }
+}
 
-  ly = y - HUD_STATUS_Y;
-  lx = x - hudStatusX;
-  if (Font5x7::textPixel(hudStatusText, 1, lx, ly)) {
-    return levelSolved ? COLOR_PLAYER_HI : COLOR_TEXT_DIM;
+bool SokobanGame::renderNextFrame() {
+  const auto* frame = renderQueue.acquire();
+  if (frame == nullptr) {
+    return false;
   }
-
-  return color;
+#if SOKOBAN_GRID_FLUSH
+  // Split the rects against the board the frame shows; a new layout comes with markAll().
+  const BoardViewport& board = frame->view.viewport;
+  dirtyCells.setBoard(board.boardX0,
+                      board.boardY0,
+                      board.boardW,
+                      board.boardH,
+                      board.tileSize,
+                      MAX_TILE_W * MAX_TILE_H);
+#endif
+  if (frame->rects.all()) {
+    invalidateDirty();
+  } else {
+    for (int i = 0; i < frame->rects.count(); i++) {
+      const auto& r = frame->rects.rect(i);
+      addDirtyRect(r.x0, r.y0, r.x1, r.y1);
+    }
+  }
+  renderView(frame->view);
+  renderQueue.release(*frame);
+  return true;
 }
 
-uint16_t SokobanGame::boardPixelAt(int x, int y) const {
-  int frameX = boardX0 - 2;
-  int frameY = boardY0 - 2;
-  int frameW = boardPixelWidth() + 4;
-  int frameH = boardPixelHeight() + 4;
-  if (x >= frameX && x < frameX + frameW && y >= frameY && y < frameY + frameH) {
-    bool onFrame = (x == frameX) || (x == frameX + frameW - 1) ||
-                   (y == frameY) || (y == frameY + frameH - 1);
-    if (onFrame) {
-      return COLOR_PANEL_LINE;
+void SokobanGame::renderTaskMain(void* ctx) {
+  SokobanGame& game = *static_cast<SokobanGame*>(ctx);
+  for (;;) {
+    if (!game.renderNextFrame()) {
+      RenderTask::pause();
     }
   }
+}
+#endif
 
-  if (x < boardX0 || y < boardY0) {
-    return COLOR_BG;
-  }
-  int rx = x - boardX0;
-  int ry = y - boardY0;
-  if (rx >= boardPixelWidth() || ry >= boardPixelHeight()) {
-    return COLOR_BG;
-  }
+template <>
+const uint8_t* SokobanGame::spritePixels<SokobanGame::SpriteVariant::Box>() {
+  static constexpr auto art = SpriteArt::generate<SPRITE_SIZE>(SpriteArt::boxPixel, BOX_COLORS);
+  return art.pixels;
+}
 
-  int gx = rx / tileSize;
-  int gy = ry / tileSize;
-  int lx = rx - gx * tileSize;
-  int ly = ry - gy * tileSize;
-  return cellPixelAt(board[gy][gx], gx, gy, lx, ly);
+template <>
+const uint8_t* SokobanGame::spritePixels<SokobanGame::SpriteVariant::BoxOnTarget>() {
+  static constexpr auto art =
+    SpriteArt::generate<SPRITE_SIZE>(SpriteArt::boxPixel, BOX_ON_TARGET_COLORS);
+  return art.pixels;
 }
 
-uint16_t SokobanGame::cellPixelAt(char cell, int gx, int gy, int lx, int ly) const {
-  (void)gx;
-  (void)gy;
-  bool hasTarget = (cell == '.' || cell == '*' || cell == '+');
-  bool wall = (cell == '#');
+template <>
+const uint8_t* SokobanGame::spritePixels<SokobanGame::SpriteVariant::Player>() {
+  static constexpr auto art =
+    SpriteArt::generate<SPRITE_SIZE>(SpriteArt::playerPixel, PLAYER_COLORS);
+  return art.pixels;
+}
 
-  if (wall) {
-    if (ly <= 1 || lx <= 1) {
-      return COLOR_WALL_HI;
-    }
-    if (ly >= tileSize - 2 || lx >= tileSize - 2) {
-      return COLOR_WALL_SH;
-    }
-    return COLOR_WALL;
+template <>
+const uint8_t* SokobanGame::spritePixels<SokobanGame::SpriteVariant::Ghost>() {
+  static constexpr auto art =
+    SpriteArt::generate<SPRITE_SIZE>(SpriteArt::ghostPixel, GHOST_COLORS);
+  return art.pixels;
+}
+
+void SokobanGame::initSpriteSlots() {
+  sprites.clear();
+  for (int i = 0; i < SpriteGrid::MAX_SPRITES; i++) {
+    spriteSlots[i].active = false;
   }
+}
 
-  uint16_t floorColor = (((gx + gy) & 1) == 0) ? COLOR_FLOOR_A : COLOR_FLOOR_B;
-  if (lx == 0 || ly == 0) {
-    return COLOR_GRID;
+void SokobanGame::bindSpriteArt(int size) {
+  if (spriteSize == size) {
+    return;
   }
+  // Frames already published carry `boxSpritePixels` and friends, which may be these caches.
+  waitForRenderIdle();
+
+  const uint8_t* boxPixels = spritePixels<SpriteVariant::Box>();
+  const uint8_t* playerPixels = spritePixels<SpriteVariant::Player>();
+#if SOKOBAN_GHOST
+  const uint8_t* ghostPixels = spritePixels<SpriteVariant::Ghost>();
+#endif
+  if (size != SPRITE_SIZE) {
+    uint32_t startUs = micros();
+    SpriteArt::rasterize(SpriteArt::boxPixel, BOX_COLORS, size, boxSpriteCache);
+    SpriteArt::rasterize(SpriteArt::playerPixel, PLAYER_COLORS, size, playerSpriteCache);
+#if SOKOBAN_GHOST
+    SpriteArt::rasterize(SpriteArt::ghostPixel, GHOST_COLORS, size, ghostSpriteCache);
+    ghostPixels = ghostSpriteCache;
+#endif
+    spriteRebuildUs = micros() - startUs;
+    spriteRebuilds++;
+    boxPixels = boxSpriteCache;
+    playerPixels = playerSpriteCache;
+#if SOKOBAN_RENDER_STATS
+    Serial.print("[render] sprites rebuilt at ");
+    Serial.print(size);
+    Serial.print(" px in ");
+    Serial.print((unsigned long)spriteRebuildUs);
+    Serial.print(" us, rebuilds=");
+    Serial.println((unsigned)spriteRebuilds);
+#endif
+  }
+  spriteSize = size;
+  boxSpritePixels = boxPixels;
+  playerSpritePixels = playerPixels;
+#if SOKOBAN_GHOST
+  ghostSpritePixels = ghostPixels;
+#endif
+}
 
-  if (hasTarget) {
-    int cx = tileSize / 2;
-    int cy = tileSize / 2;
-    int dx = lx - cx;
-    int dy = ly - cy;
-    int dist2 = dx * dx + dy * dy;
-    int outerR = tileSize / 2 - 3;
-    int innerR = tileSize / 2 - 5;
-    int holeR = tileSize / 2 - 7;
-    if (outerR < 3) {
-      outerR = 3;
-    }
-    if (innerR < 2) {
-      innerR = 2;
-    }
-    if (holeR < 1) {
-      holeR = 1;
-    }
-    if (dist2 <= outerR * outerR) {
-      if (dist2 <= holeR * holeR) {
-        return floorColor;
+void SokobanGame::bindTargetRings(int size) {
+  if (targetRingSize == size) {
+    return;
+  }
+  // Queued frames draw targets through `viewport.targetRing`, which points in here.
+  waitForRenderIdle();
+#if SOKOBAN_TARGET_PULSE
+  static_assert(sizeof(PULSE_SHRINK) / sizeof(PULSE_SHRINK[0]) == TARGET_RING_FRAMES,
+                "one shrink per marker frame");
+#endif
+  for (int i = 0; i < TARGET_RING_FRAMES; i++) {
+#if SOKOBAN_TARGET_PULSE
+    targetRings[i].build(size, PULSE_SHRINK[i]);
+#else
+    targetRings[i].build(size, 0);
+#endif
+  }
+  targetRingSize = size;
+}
+
+void SokobanGame::syncSpritesFromBoard() {
+  for (int i = FIRST_BOX_SPRITE_SLOT; i < PLAYER_SPRITE_SLOT; i++) {
+    spriteSlots[i].active = false;
+  }
+
+  int slot = FIRST_BOX_SPRITE_SLOT;
+  for (int y = 0; y < viewport.boardH; y++) {
+    for (int x = 0; x < viewport.boardW; x++) {
+      if (!SokobanRules::isBox(viewport.board[y][x])) {
+        continue;
+      }
+      if (slot >= PLAYER_SPRITE_SLOT) {
+        continue;
       }
-      return dist2 <= innerR * innerR ? COLOR_TARGET_HI : COLOR_TARGET;
+      spriteSlots[slot++] = SpriteSlot{
+        (int16_t)viewport.cellX(x), (int16_t)viewport.cellY(y), true};
     }
   }
 
-  return floorColor;
+  syncPlayerSprite();
 }
 
-uint16_t SokobanGame::overlayPixelAt(int x, int y) const {
-  if (!levelSolved) {
-    return 0;
-  }
+void SokobanGame::syncPlayerSprite() {
+  spriteSlots[PLAYER_SPRITE_SLOT] = SpriteSlot{
+    (int16_t)viewport.cellX(playerX), (int16_t)viewport.cellY(playerY), true};
+}
 
-  if (x < overlayX0 || x >= overlayX0 + overlayW || y < overlayY0 || y >= overlayY0 + OVERLAY_H) {
-    return 0;
-  }
+#if SOKOBAN_GHOST
+void SokobanGame::resetGhost() {
+  runLog.clear();
+  ghostActive = currentLevel < LEVEL_COUNT && bestRuns[currentLevel].length() > 0;
+  ghostX = playerX;
+  ghostY = playerY;
+  ghostStep = 0;
+  syncGhostSprite();
+}
 
-  if (y < overlayY0 + 2 || y >= overlayY0 + OVERLAY_H - 2) {
-    return COLOR_ACCENT;
+void SokobanGame::advanceGhost() {
+  if (!ghostActive) {
+    return;
   }
-
-  int ly = y - (overlayY0 + OVERLAY_TEXT1_Y_OFF);
-  int lx = x - overlayTitleX;
-  if (Font5x7::textPixel(overlayTitleText, 2, lx, ly)) {
-    return COLOR_TEXT;
+  const MoveLog& best = bestRuns[currentLevel];
+  const int target = (levelMoves < (uint32_t)best.length()) ? (int)levelMoves : best.length();
+  const int oldX = ghostX;
+  const int oldY = ghostY;
+  // A walk or a planned push moves the player many cells at once; the ghost catches up in
+  // one go as well, so it still costs a single cell pair.
+  for (; ghostStep < target; ghostStep++) {
+    SokobanRules::Dir dir = best.move(ghostStep);
+    ghostX += SokobanRules::DIR_DX[dir];
+    ghostY += SokobanRules::DIR_DY[dir];
+  }
+  if (ghostX == oldX && ghostY == oldY) {
+    return;
   }
+  markCellDirty(oldX, oldY);
+  markCellDirty(ghostX, ghostY);
+  syncGhostSprite();
+}
+
+void SokobanGame::syncGhostSprite() {
+  spriteSlots[GHOST_SPRITE_SLOT] = SpriteSlot{
+    (int16_t)viewport.cellX(ghostX), (int16_t)viewport.cellY(ghostY), ghostActive};
+}
+#endif
 
-  ly = y - (overlayY0 + OVERLAY_TEXT2_Y_OFF);
-  lx = x - overlaySubX;
-  if (Font5x7::textPixel(overlaySubText, 1, lx, ly)) {
-    return COLOR_TEXT_DIM;
+void SokobanGame::PlayfieldView::hudRow(int y, int xs, int xe, uint16_t* row) const {
+  if (y >= HUD_H - 2) {
+    PixelFill::fill(row, xe - xs, colors[Theme::PANEL_LINE]);
+    return;
   }
 
-  return COLOR_OVERLAY;
+  PixelFill::fill(row, xe - xs, colors[Theme::PANEL]);
+  textRow(row, xs, xe, y, "SOKOBAN", 2, hudTitleX, HUD_TITLE_Y, colors[Theme::ACCENT]);
+  textRow(row, xs, xe, y, hudLevelText, 2, hudLevelX, HUD_LEVEL_Y, colors[Theme::TEXT]);
+  textRow(row, xs, xe, y, hudMovesText, 1, hudMovesX, HUD_MOVES_Y, colors[Theme::TEXT]);
+  parRow(y, xs, xe, row);
+  timerRow(y, xs, xe, row);
+  textRow(row, xs, xe, y, hudTotalText, 1, hudTotalX, HUD_TOTAL_Y, colors[Theme::TEXT]);
+  textRow(row,
+          xs,
+          xe,
+          y,
+          hudStatusText,
+          1,
+          hudStatusX,
+          HUD_STATUS_Y,
+          levelSolved ? colors[Theme::PLAYER_HI] : colors[Theme::TEXT_DIM]);
 }
 
-void SokobanGame::renderRegionToBuffer(int x0, int y0, int w, int h, uint16_t* buf) {
-  for (int yy = 0; yy < h; yy++) {
-    int y = y0 + yy;
-    for (int xx = 0; xx < w; xx++) {
-      int x = x0 + xx;
-      buf[yy * w + xx] = pixelAt(x, y);
+void SokobanGame::PlayfieldView::parRow(int y, int xs, int xe, uint16_t* row) const {
+  int ly = y - HUD_MOVES_Y;
+  if (hudParW == 0 || ly < 0 || ly >= PAR_MASK_ROWS) {
+    return;
+  }
+  const uint8_t* bits = hudParMask[ly];
+  int from = (hudParX > xs) ? hudParX : xs;
+  int to = (hudParX + hudParW < xe) ? hudParX + hudParW : xe;
+  for (int x = from; x < to; x++) {
+    int lx = x - hudParX;
+    if ((bits[lx >> 3] >> (lx & 7)) & 1u) {
+      row[x - xs] = colors[Theme::TEXT_DIM];
     }
   }
+}
 
-  sprites.renderRegion(x0, y0, w, h, buf);
-
-  if (levelSolved) {
-    for (int yy = 0; yy < h; yy++) {
-      int y = y0 + yy;
-      for (int xx = 0; xx < w; xx++) {
-        int x = x0 + xx;
-        uint16_t c = overlayPixelAt(x, y);
-        if (c != 0) {
-          buf[yy * w + xx] = c;
-        }
+void SokobanGame::PlayfieldView::timerRow(int y, int xs, int xe, uint16_t* row) const {
+  int ly = y - HUD_TIMER_Y;
+  if (ly < 0 || ly >= TIMER_GLYPH_ROWS) {
+    return;
+  }
+  for (int i = 0; i < TIMER_CHARS; i++) {
+    char c = hudTimerText[i];
+    int glyph = (c >= '0' && c <= '9') ? c - '0' : (c == ':' ? 10 : 11);
+    uint8_t bits = timerGlyphs[glyph][ly];
+    int cellX = hudTimerX + i * TIMER_CELL_W;
+    for (int lx = 0; bits != 0; lx++, bits >>= 1) {
+      int x = cellX + lx;
+      if ((bits & 1u) && x >= xs && x < xe) {
+        row[x - xs] = colors[Theme::TEXT];
       }
     }
   }
 }
+
+void SokobanGame::PlayfieldView::overlayRow(int y, int xs, int xe, uint16_t* row) const {
+  if (y < overlayY0 + 2 || y >= overlayY0 + OVERLAY_H - 2) {
+    PixelFill::fill(row, xe - xs, colors[Theme::ACCENT]);
+    return;
+  }
+  PixelFill::fill(row, xe - xs, colors[Theme::OVERLAY]);
+  textRow(row,
+          xs,
+          xe,
+          y,
+          overlayTitleText,
+          2,
+          overlayTitleX,
+          overlayY0 + OVERLAY_TEXT1_Y_OFF,
+          colors[Theme::TEXT]);
+  textRow(row,
+          xs,
+          xe,
+          y,
+          overlaySubText,
+          1,
+          overlaySubX,
+          overlayY0 + OVERLAY_TEXT2_Y_OFF,
+          colors[Theme::TEXT_DIM]);
+}
+
+void SokobanGame::PlayfieldView::textRow(uint16_t* row,
+                                         int xs,
+                                         int xe,
+                                         int y,
+                                         const char* text,
+                                         int scale,
+                                         int textX,
+                                         int textY,
+                                         uint16_t color) {
+  int ly = y - textY;
+  if (ly < 0 || ly >= FONT_CELL_H * scale) {
+    return;
+  }
+  int from = (textX > xs) ? textX : xs;
+  int textRight = textX + Font5x7::textWidth(text, scale);
+  int to = (textRight < xe) ? textRight : xe;
+  for (int x = from; x < to; x++) {
+    if (Font5x7::textPixel(text, scale, x - textX, ly)) {
+      row[x - xs] = color;
+    }
+  }
+}
@@ -12,113 +12,440 @@
 #include "SGF/IScreen.h"
 #include "SGF/InputPin.h"
 #include "SGF/Scene.h"
-#include "SGF/Sprites.h"
 #include "SGF/TileFlusher.h"
+#include "BoardViewport.h"
+#include "ButtonSet.h"
 #include "GameOverScene.h"
+#include "IProgressStorage.h"
+#include "LevelSelectScene.h"
+#include "PathFinder.h"
+#include "PixelFill.h"
 #include "PlayingScene.h"
+#include "ProgressStore.h"
+#include "PushPlanner.h"
+#include "RaceScene.h"
+#include "RenderTask.h"
+#include "SokobanLevels.h"
+#include "SokobanRules.h"
+#include "SpriteArt.h"
+#include "SpriteGrid.h"
+#include "TargetRing.h"
+#include "Theme.h"
 #include "TitleScene.h"
 
+#if SOKOBAN_DUAL_CORE
+#include "RenderQueue.h"
+#endif
+
+// Build with -DSOKOBAN_TILE_SIGNATURES=1 to skip SPI pushes of screen cells whose content
+// matches what was last sent (see TileSignatureCache).
+#ifndef SOKOBAN_TILE_SIGNATURES
+#define SOKOBAN_TILE_SIGNATURES 0
+#endif
+
+#if SOKOBAN_TILE_SIGNATURES
+#include "TileSignatureCache.h"
+#endif
+
+class Print;
+
+// Build with -DSOKOBAN_MEMORY_REPORT=1 to print the RAM footprint over Serial at startup.
+#ifndef SOKOBAN_MEMORY_REPORT
+#define SOKOBAN_MEMORY_REPORT 0
+#endif
+
+// Build with -DSOKOBAN_RENDER_STATS=1 to log render-side costs (sprite rebuilds) over Serial.
+#ifndef SOKOBAN_RENDER_STATS
+#define SOKOBAN_RENDER_STATS 0
+#endif
+
+// Build with -DSOKOBAN_SCREENSHOT=1 to stream the screen over Serial when 'S' is received
+// (see ScreenshotStream; decode with tools/screenshot_decode).
+#ifndef SOKOBAN_SCREENSHOT
+#define SOKOBAN_SCREENSHOT 0
+#endif
+
+// Colour theme at startup, a `Theme::Id` value; the title screen cycles through the others.
+#ifndef SOKOBAN_THEME
+#define SOKOBAN_THEME 0
+#endif
+
+// Build with -DSOKOBAN_ENDLESS=1 to continue past the last built-in level with levels
+// generated on the device (see LevelGenerator). Generated levels do not touch progress.
+#ifndef SOKOBAN_ENDLESS
+#define SOKOBAN_ENDLESS 0
+#endif
+
+#if SOKOBAN_ENDLESS
+#include "LevelGenerator.h"
+#endif
+
+// Build with -DSOKOBAN_BUDGETED_FLUSH=1 to spread full playfield repaints over several frames
+// (see RepaintSchedule), so input keeps being sampled while a new level paints in.
+#ifndef SOKOBAN_BUDGETED_FLUSH
+#define SOKOBAN_BUDGETED_FLUSH 0
+#endif
+
+// Build with -DSOKOBAN_GRID_FLUSH=1 to flush the board in chunks of whole cells aligned to the
+// board grid (see DirtyCellMap) instead of screen-anchored 64x64 tiles.
+#ifndef SOKOBAN_GRID_FLUSH
+#define SOKOBAN_GRID_FLUSH 0
+#endif
+
+#if SOKOBAN_GRID_FLUSH
+#if SOKOBAN_TILE_SIGNATURES
+// Signature cells are anchored to the screen, grid chunks to the board; pushes of one would
+// straddle the other's cells.
+#error "SOKOBAN_GRID_FLUSH and SOKOBAN_TILE_SIGNATURES cannot be combined"
+#endif
+#include "DirtyCellMap.h"
+#endif
+
+// Build with -DSOKOBAN_LATENCY_PROBE=1 to log a histogram of button-to-pixel latencies over
+// Serial (see LatencyProbe; tools/latency_sim models the same path on a host).
+#ifndef SOKOBAN_LATENCY_PROBE
+#define SOKOBAN_LATENCY_PROBE 0
+#endif
+
+#if SOKOBAN_LATENCY_PROBE
+#include "LatencyProbe.h"
+#endif
+
+// Build with -DSOKOBAN_GHOST=1 to replay this session's best run of a built-in level as a
+// see-through player that takes one step per live move.
+#ifndef SOKOBAN_GHOST
+#define SOKOBAN_GHOST 0
+#endif
+
+#if SOKOBAN_GHOST
+#include "MoveLog.h"
+#endif
+
+// Build with -DSOKOBAN_TARGET_PULSE=1 to pulse the rings of uncovered targets, repainting
+// only their boxes and never pushing more than `PULSE_MAX_BYTES_PER_S` for it.
+#ifndef SOKOBAN_TARGET_PULSE
+#define SOKOBAN_TARGET_PULSE 0
+#endif
+
+#if SOKOBAN_TARGET_PULSE
+#include <atomic>
+#endif
+
+// Build with -DSOKOBAN_FIXED_PANEL=0 to drop the playfield renderers specialised on the
+// 240x240 and 320x240 panel sizes and always use the runtime-size one.
+#ifndef SOKOBAN_FIXED_PANEL
+#define SOKOBAN_FIXED_PANEL 1
+#endif
+
+#if SOKOBAN_BUDGETED_FLUSH
+#if SOKOBAN_DUAL_CORE
+// The render task already keeps flushes off the input loop.
+#error "SOKOBAN_BUDGETED_FLUSH is for single-core builds"
+#endif
+#include "RepaintSchedule.h"
+#endif
+
 class SokobanGame : public Game {
 public:
+  // `rivalHardwareProfile` wires the second racer's buttons (`input` only) with SOKOBAN_RACE,
+  // for presets that have a second button set; other builds ignore it.
   SokobanGame(
     IRenderTarget& renderTarget,
     IScreen& screen,
-    const SGFHardware::HardwareProfile& hardwareProfile);
+    const SGFHardware::HardwareProfile& hardwareProfile,
+    IProgressStorage& progressStorage,
+    const SGFHardware::HardwareProfile* rivalHardwareProfile = nullptr);
 
   void setup();
 
 private:
-  struct LevelDef {
-    uint8_t width = 0;
-    uint8_t height = 0;
-    const char* const* rows = nullptr;
-  };
-
   static constexpr uint32_t FRAME_DEFAULT_STEP_US = 10000u;
   static constexpr uint32_t FRAME_MAX_STEP_US = 30000u;
   static constexpr int MAX_TILE_SIZE = 20;
   static constexpr int SPRITE_SIZE = 16;
-  static constexpr int BOARD_MAX_W = 14;
-  static constexpr int BOARD_MAX_H = 10;
+  static constexpr int BOARD_MAX_W = SokobanRules::BOARD_MAX_W;
+  static constexpr int BOARD_MAX_H = SokobanRules::BOARD_MAX_H;
   static constexpr int HUD_H = 44;
   static constexpr int MAX_TILE_W = 64;
   static constexpr int MAX_TILE_H = 64;
-  static constexpr uint8_t LEVEL_COUNT = 10;
+  static constexpr uint8_t LEVEL_COUNT = SokobanLevels::LEVEL_COUNT;
   static constexpr float LEVEL_SOLVED_DELAY_S = 0.75f;
   static constexpr int OVERLAY_H = 52;
+  // "PAR 65535" at scale 1, kept as a 1-bit mask of the glyph rows.
+  static constexpr int PAR_TEXT_MAX = 9;
+  static constexpr int PAR_MASK_W = PAR_TEXT_MAX * 6 - 1;
+  static constexpr int PAR_MASK_ROWS = 7;
+  static constexpr int PAR_MASK_ROW_BYTES = (PAR_MASK_W + 7) / 8;
+  // Level timer "mm:ss.t": one fixed 6 px cell per character, so a changed digit is redrawn
+  // on its own. Glyphs for 0-9, ':' and '.' are kept as 5-bit rows.
+  static constexpr int TIMER_CHARS = 7;
+  static constexpr int TIMER_CELL_W = 6;
+  static constexpr int TIMER_GLYPH_COUNT = 12;
+  static constexpr int TIMER_GLYPH_ROWS = 7;
+  static constexpr uint32_t TIMER_MAX_TENTHS = 59999u;
+  // Adds a frame's `delta` to `elapsedUs` and returns the elapsed tenths, capped at
+  // `TIMER_MAX_TENTHS`. Each frame rounds to a whole microsecond on its own, so the error no
+  // longer grows with the float sum.
+  static uint32_t advanceTimerUs(uint64_t& elapsedUs, float delta) {
+    elapsedUs += (uint64_t)(delta * 1000000.0f + 0.5f);
+    const uint64_t tenths = elapsedUs / 100000u;
+    return (tenths > TIMER_MAX_TENTHS) ? TIMER_MAX_TENTHS : (uint32_t)tenths;
+  }
+  // Generation time per physics step while the solved overlay is up, and the reverse moves
+  // run between clock checks.
+  static constexpr uint32_t GENERATOR_BUDGET_US = 4000u;
+  static constexpr int GENERATOR_SLICE_MOVES = 64;
+  // Repaint time per frame with SOKOBAN_BUDGETED_FLUSH; a chunk started inside the budget
+  // still finishes, so a frame can run over by up to one chunk.
+  static constexpr uint32_t FLUSH_BUDGET_US = 4000u;
+  // `currentLevel` stops counting here on very long endless runs.
+  static constexpr uint8_t LAST_LEVEL_NUMBER = 254;
+  // Target marker frames: the static ring, plus the steps of the pulse cycle with
+  // SOKOBAN_TARGET_PULSE, each shown for `PULSE_FRAME_S`. The pulse's pushes are capped at
+  // `PULSE_MAX_BYTES_PER_S`, well under 1% of even a slow SPI link.
+  static constexpr int TARGET_RING_FRAMES = SOKOBAN_TARGET_PULSE ? 4 : 1;
+  static constexpr float PULSE_FRAME_S = 0.25f;
+  static constexpr float PULSE_MAX_BYTES_PER_S = 16000.0f;
+  static_assert(MAX_TILE_SIZE <= TargetRing::MAX_SIZE, "target rings must cover every tile");
+
+  static constexpr SpriteArt::BoxColors BOX_COLORS{
+    Theme::BOX, Theme::BOX_HI, Theme::BOX_SH, Theme::BOX_SH};
+  static constexpr SpriteArt::BoxColors BOX_ON_TARGET_COLORS{
+    Theme::BOX, Theme::BOX_HI, Theme::BOX_SH, Theme::TARGET};
+  static constexpr SpriteArt::PlayerColors PLAYER_COLORS{
+    Theme::PLAYER, Theme::PLAYER_HI, Theme::PLAYER_SH};
+  static constexpr SpriteArt::PlayerColors GHOST_COLORS{Theme::GHOST, Theme::GHOST, Theme::GHOST};
 
-  static constexpr uint16_t COLOR_BG = Color565::rgb(8, 12, 18);
-  static constexpr uint16_t COLOR_PANEL = Color565::rgb(14, 22, 32);
-  static constexpr uint16_t COLOR_PANEL_LINE = Color565::rgb(42, 64, 82);
-  static constexpr uint16_t COLOR_TEXT = Color565::rgb(228, 236, 244);
-  static constexpr uint16_t COLOR_TEXT_DIM = Color565::rgb(140, 160, 176);
-  static constexpr uint16_t COLOR_ACCENT = Color565::rgb(255, 196, 96);
-  static constexpr uint16_t COLOR_WALL = Color565::rgb(54, 74, 98);
-  static constexpr uint16_t COLOR_WALL_HI = Color565::rgb(86, 116, 150);
-  static constexpr uint16_t COLOR_WALL_SH = Color565::rgb(30, 42, 58);
-  static constexpr uint16_t COLOR_FLOOR_A = Color565::rgb(18, 26, 34);
-  static constexpr uint16_t COLOR_FLOOR_B = Color565::rgb(14, 22, 30);
-  static constexpr uint16_t COLOR_GRID = Color565::rgb(24, 36, 46);
-  static constexpr uint16_t COLOR_TARGET = Color565::rgb(255, 40, 40);
-  static constexpr uint16_t COLOR_TARGET_HI = Color565::rgb(255, 160, 160);
-  static constexpr uint16_t COLOR_BOX = Color565::rgb(188, 136, 72);
-  static constexpr uint16_t COLOR_BOX_HI = Color565::rgb(236, 188, 108);
-  static constexpr uint16_t COLOR_BOX_SH = Color565::rgb(120, 84, 44);
-  static constexpr uint16_t COLOR_PLAYER = Color565::rgb(92, 220, 148);
-  static constexpr uint16_t COLOR_PLAYER_HI = Color565::rgb(156, 255, 196);
-  static constexpr uint16_t COLOR_PLAYER_SH = Color565::rgb(44, 122, 78);
-  static constexpr uint16_t COLOR_OVERLAY = Color565::rgb(20, 28, 40);
-  static constexpr uint16_t COLOR_GO_BG = Color565::rgb(14, 8, 10);
-  static constexpr uint16_t COLOR_GO_LINE = Color565::rgb(180, 24, 24);
-  static constexpr uint16_t COLOR_GO_TITLE = Color565::rgb(255, 48, 48);
+  // Each variant's bitmap is generated at compile time and only linked into flash when
+  // `spritePixels<V>()` is referenced, so new variants cost nothing until they are drawn.
+  enum class SpriteVariant : uint8_t {
+    Box,
+    BoxOnTarget,
+    Player,
+    Ghost,
+  };
+
+  // Which renderer can reproduce the current screen. Title and game-over screens are drawn
+  // straight to the panel, so there is nothing to re-render them from.
+  enum class ScreenshotSource : uint8_t {
+    None,
+    Playfield,
+    LevelSelect,
+#if SOKOBAN_RACE
+    Race,
+#endif
+  };
+
+  struct SpriteSlot {
+    int16_t x;
+    int16_t y;
+    bool active;
+  };
+
+  // Everything the playfield pixel functions read, captured from the game when a frame is
+  // flushed. Rendering only touches a view, so with SOKOBAN_DUAL_CORE the render task draws
+  // one while the logic loop keeps changing the game.
+  struct PlayfieldView {
+    BoardViewport viewport;
+    int screenW;
+    int screenH;
+    SpriteSlot spriteSlots[SpriteGrid::MAX_SPRITES];
+    int spriteSize;
+    const uint8_t* boxSpritePixels;
+    const uint8_t* playerSpritePixels;
+#if SOKOBAN_GHOST
+    const uint8_t* ghostSpritePixels;
+#endif
+    // RGB565 value of every `Theme::Color`; a theme switch only changes this pointer.
+    const uint16_t* colors;
+    bool cursorActive;
+    int cursorX;
+    int cursorY;
+    bool boxSelected;
+    int selectedX;
+    int selectedY;
+    bool levelSolved;
+    char hudLevelText[12];
+    char hudMovesText[16];
+    char hudTotalText[16];
+    char hudStatusText[16];
+    int hudTitleX;
+    int hudLevelX;
+    int hudMovesX;
+    int hudTotalX;
+    int hudStatusX;
+    uint8_t hudParMask[PAR_MASK_ROWS][PAR_MASK_ROW_BYTES];
+    int hudParX;
+    int hudParW;
+    char hudTimerText[TIMER_CHARS + 1];
+    int hudTimerX;
+    const uint8_t (*timerGlyphs)[TIMER_GLYPH_ROWS];
+    char overlayTitleText[24];
+    char overlaySubText[24];
+    int overlayX0;
+    int overlayY0;
+    int overlayW;
+    int overlayTitleX;
+    int overlaySubX;
+#if SOKOBAN_LATENCY_PROBE
+    // Input edge behind the move this frame shows; 0 when none.
+    uint32_t latencyEdgeUs;
+#endif
+#if SOKOBAN_TARGET_PULSE
+    // Pulse ticks up to this frame; a frame that brings new ones pays for its flush.
+    uint32_t pulseTicks;
+#endif
+
+    // W/H of 0 clip against `screenW`/`screenH`; positive values are a compile-time panel
+    // size selected through `useFixedPanel()`.
+    template <int W, int H>
+    void renderRegion(
+      const SpriteGrid& sprites, int x0, int y0, int w, int h, uint16_t* buf) const;
+
+    // Row renderers: fill pixels [xs, xe) of row `y` into `row`, which holds pixel `xs` at
+    // index 0. Solid runs go through `PixelFill`; only glyphs are per pixel.
+    void hudRow(int y, int xs, int xe, uint16_t* row) const;
+    void parRow(int y, int xs, int xe, uint16_t* row) const;
+    void timerRow(int y, int xs, int xe, uint16_t* row) const;
+    void overlayRow(int y, int xs, int xe, uint16_t* row) const;
+    static void textRow(uint16_t* row,
+                        int xs,
+                        int xe,
+                        int y,
+                        const char* text,
+                        int scale,
+                        int textX,
+                        int textY,
+                        uint16_t color);
+  };
+
+  using RegionRenderer =
+    void (PlayfieldView::*)(const SpriteGrid&, int, int, int, int, uint16_t*) const;
 
   IRenderTarget& renderTarget;
   IScreen& screen;
   SGFHardware::HardwareProfile hardwareProfile;
+#if SOKOBAN_TILE_SIGNATURES
+  TileSignatureCache tileSignatures;
+#endif
+  // Render target size cached at setup; layout code reads these instead of the virtual getters.
+  int screenW = 0;
+  int screenH = 0;
+  RegionRenderer regionRenderer = nullptr;
+  // Owned by whichever side draws the playfield: the logic loop, or the render task while
+  // it holds the display (see `waitForRenderIdle()`).
   DirtyRects dirty;
   TileFlusher flusher;
-  SpriteLayer sprites;
+#if SOKOBAN_GRID_FLUSH
+  // Board part of the dirty area, same owner as `dirty`.
+  DirtyCellMap dirtyCells;
+#endif
+  SpriteGrid sprites;
   uint16_t regionBuf[MAX_TILE_W * MAX_TILE_H]{};
-  uint16_t boxSpritePixels[SPRITE_SIZE * SPRITE_SIZE]{};
-  uint16_t playerSpritePixels[SPRITE_SIZE * SPRITE_SIZE]{};
-  uint8_t pinLeft = 0;
-  uint8_t pinRight = 0;
-  uint8_t pinUp = 0;
-  uint8_t pinDown = 0;
-  uint8_t pinFire = 0;
-  DebouncedInputPin leftPinInput;
-  DebouncedInputPin rightPinInput;
-  DebouncedInputPin upPinInput;
-  DebouncedInputPin downPinInput;
-  DebouncedInputPin firePinInput;
-
-  DigitalAction leftAction;
-  DigitalAction rightAction;
-  DigitalAction upAction;
-  DigitalAction downAction;
-  DigitalAction fireAction;
+  // Sprites rasterized at `spriteSize`; unused while it equals `SPRITE_SIZE`.
+  uint8_t boxSpriteCache[MAX_TILE_SIZE * MAX_TILE_SIZE]{};
+  uint8_t playerSpriteCache[MAX_TILE_SIZE * MAX_TILE_SIZE]{};
+#if SOKOBAN_GHOST
+  uint8_t ghostSpriteCache[MAX_TILE_SIZE * MAX_TILE_SIZE]{};
+#endif
+  int spriteSize = 0;
+  const uint8_t* boxSpritePixels = nullptr;
+  const uint8_t* playerSpritePixels = nullptr;
+#if SOKOBAN_GHOST
+  const uint8_t* ghostSpritePixels = nullptr;
+#endif
+  // Target marker spans at `targetRingSize`; shared by both sides like the sprite caches.
+  TargetRing targetRings[TARGET_RING_FRAMES]{};
+  int targetRingSize = 0;
+  // Sprite positions as the game sees them; copied onto `sprites` by the side that renders.
+  SpriteSlot spriteSlots[SpriteGrid::MAX_SPRITES]{};
+  uint16_t spriteRebuilds = 0;
+  uint32_t spriteRebuildUs = 0;
+  ButtonSet buttons;
   PressReleaseAction fireConfirm;
+#if SOKOBAN_RACE
+  // The second racer's wiring; without it the level select offers no race.
+  SGFHardware::HardwareProfile rivalProfile{};
+  bool rivalInputSet = false;
+  ButtonSet rivalButtons;
+  PressReleaseAction rivalFireConfirm;
+#endif
 
   SceneSwitcher sceneSwitcher;
   TitleScene titleScene;
+  LevelSelectScene levelSelectScene;
   PlayingScene playingScene;
   GameOverScene gameOverScene;
+#if SOKOBAN_RACE
+  RaceScene raceScene;
+#endif
 
-  char board[BOARD_MAX_H][BOARD_MAX_W]{};
-  int boardW = 0;
-  int boardH = 0;
-  int tileSize = MAX_TILE_SIZE;
-  int boardX0 = 0;
-  int boardY0 = 0;
+  BoardViewport viewport{};
   int playerX = 0;
   int playerY = 0;
   int remainingCrates = 0;
+  PathFinder pathFinder;
+  bool cursorActive = false;
+  int cursorX = 0;
+  int cursorY = 0;
+  PushPlanner pushPlanner;
+  bool boxSelected = false;
+  int selectedX = 0;
+  int selectedY = 0;
+  uint32_t lastPlanUs = 0;
 
+  // Result of the pack CRC check at setup; no built-in level is decoded from a bad pack.
+  bool packValid = false;
   uint8_t currentLevel = 0;
   uint8_t completedLevels = 0;
   uint32_t totalMoves = 0;
   uint32_t levelMoves = 0;
+  uint32_t levelPushes = 0;
   uint32_t finalMoves = 0;
+  uint16_t parMoves = 0;
+  static_assert(SOKOBAN_THEME >= 0 && SOKOBAN_THEME < Theme::THEME_COUNT, "no such theme");
+  Theme::Id theme = (Theme::Id)SOKOBAN_THEME;
+  // Palette of `theme`, in flash; see `setTheme()`.
+  const uint16_t* themeColors = Theme::palette((Theme::Id)SOKOBAN_THEME);
+#if SOKOBAN_GHOST
+  // The moves of the attempt in progress, and the shortest solved run of each built-in level
+  // this session. Only RAM: the progress record has no room for move lists.
+  MoveLog runLog;
+  MoveLog bestRuns[LEVEL_COUNT];
+  // The ghost has replayed `ghostStep` moves of `bestRuns[currentLevel]`; hidden when the
+  // level has no best run yet.
+  bool ghostActive = false;
+  int ghostX = 0;
+  int ghostY = 0;
+  int ghostStep = 0;
+#endif
+  // Whole microseconds, so the clock does not drift the way summing float deltas does.
+  uint64_t levelTimeUs = 0;
+  uint32_t levelTimeTenths = 0;
+#if SOKOBAN_TARGET_PULSE
+  // Logic side: the marker frame shown, time spent on it, and the byte budget the next tick
+  // spends from. Bytes pushed for earlier ticks are settled against the budget as the
+  // render side reports them, so the cap holds on what was sent, not on an estimate.
+  uint8_t targetFrame = 0;
+  float pulseFrameS = 0.0f;
+  float pulseBudgetBytes = 0.0f;
+  uint32_t pulseChargedBytes = 0;
+  uint32_t pulseMovesSeen = 0;
+  uint32_t pulseTicks = 0;
+  // Render side: the last tick paid for and the running total of bytes flushed for ticks.
+  uint32_t pulseRenderedTicks = 0;
+  std::atomic<uint32_t> pulsePushedBytes{0};
+#if SOKOBAN_RENDER_STATS
+  uint32_t pulseWindowStartUs = 0;
+  uint32_t pulseWindowBytes = 0;
+#endif
+#endif
+  ProgressStore progress;
+#if SOKOBAN_ENDLESS
+  LevelGenerator generator;
+  bool generatingLevel = false;
+  uint32_t generatorSeed = 0;
+#endif
 
   bool levelSolved = false;
   float levelSolvedTimer = 0.0f;
@@ -131,6 +458,14 @@ private:
   int hudMovesX = 8;
   int hudTotalX = 0;
   int hudStatusX = 0;
+  // Rasterized by `cacheParGlyphs()` when a level loads; width 0 hides it.
+  uint8_t hudParMask[PAR_MASK_ROWS][PAR_MASK_ROW_BYTES]{};
+  int hudParX = 0;
+  int hudParW = 0;
+  char hudTimerText[TIMER_CHARS + 1]{};
+  int hudTimerX = 8;
+  // Filled once by `cacheTimerGlyphs()`; read by both sides, never written afterwards.
+  uint8_t timerGlyphs[TIMER_GLYPH_COUNT][TIMER_GLYPH_ROWS]{};
   char overlayTitleText[24]{};
   char overlaySubText[24]{};
   int overlayX0 = 0;
@@ -139,34 +474,93 @@ private:
   int overlayTitleX = 0;
   int overlaySubX = 0;
 
+#if SOKOBAN_DUAL_CORE
+  RenderQueue<PlayfieldView> renderQueue;
+  bool renderTaskStarted = false;
+  bool renderTaskOwnsDisplay = false;
+#else
+  PlayfieldView frontView{};
+#endif
+#if SOKOBAN_BUDGETED_FLUSH
+  RepaintSchedule repaint;
+#endif
+#if SOKOBAN_LATENCY_PROBE
+  // Logic side: the edge seen by this physics step, and the one a move handed to the next
+  // captured frame. The probe itself belongs to the side that renders.
+  uint32_t inputEdgeUs = 0;
+  uint32_t latencyEdgeUs = 0;
+  LatencyProbe latencyProbe;
+#endif
+  ScreenshotSource screenshotSource = ScreenshotSource::None;
+
   friend class TitleScene;
+  friend class LevelSelectScene;
   friend class PlayingScene;
   friend class GameOverScene;
-
-  static const LevelDef LEVELS[LEVEL_COUNT];
+  friend class RaceScene;
+  friend struct SokobanMemoryReport;
 
   void onSetup() override;
   void onPhysics(float delta) override;
   void onProcess(float delta) override;
 
-  void startNewGame();
+  void startNewGame(uint8_t firstLevel);
   void loadLevel(uint8_t levelIndex);
+  // `SokobanLevels::load()` gated on `packValid`.
+  bool loadPackLevel(uint8_t index, SokobanRules::Board& board, int& width, int& height) const;
   void advanceAfterLevelSolved();
+#if SOKOBAN_ENDLESS
+  void startLevelGeneration();
+  // Runs the generator for up to `GENERATOR_BUDGET_US` and loads the level once it is done.
+  void stepLevelGeneration();
+#endif
 
   bool tryMove(int dx, int dy);
-  bool inBounds(int x, int y) const;
-  static bool isBox(char cell);
-  static bool isFreeForPlayer(char cell);
-  static bool isFreeForBox(char cell);
+  void toggleWalkCursor();
+  void moveWalkCursor(int dx, int dy);
+  bool confirmCursor();
+  bool walkToCursor();
+  bool pushSelectedBoxToCursor();
+  void clearBoxSelection();
+  void movePlayerTo(int x, int y);
   void clearPlayerAt(int x, int y);
   void placePlayerAt(int x, int y);
   void removeBoxAt(int x, int y);
   void placeBoxAt(int x, int y);
   void updateLevelSolvedState();
+#if SOKOBAN_GHOST
+  void resetGhost();
+  // Replays best-run moves until the ghost has made as many as the player, then marks only
+  // its old and new cells dirty.
+  void advanceGhost();
+  void syncGhostSprite();
+#endif
 
+#if SOKOBAN_SCREENSHOT
+  void pollDebugCommands();
+  // Re-renders the current screen in strips through `regionBuf` and streams it to `out`.
+  void streamScreenshot(Print& out);
+#endif
   void renderTitleScreen();
+  // Swaps the palette every screen resolves its colours through. Nothing is re-rasterized;
+  // the caller repaints whatever is on screen.
+  void setTheme(Theme::Id id);
   void renderGameOverScreen();
   void refreshHudTexts();
+  void cacheParGlyphs();
+  void cacheTimerGlyphs();
+  void resetLevelTimer();
+  // Advances the timer by a physics step and marks only the timer cells whose glyph changed.
+  void advanceLevelTimer(float delta);
+#if SOKOBAN_TARGET_PULSE
+  void resetTargetPulse();
+  // Steps the target pulse from `onProcess` and marks only the ring boxes of uncovered
+  // targets. A tick waits while a move is going out, a repaint is under way or the byte
+  // budget cannot cover it; the pulse slows down rather than exceed the cap.
+  void advanceTargetPulse(float delta);
+  // Render side: charges the pixels of a flush that showed new pulse ticks.
+  void notePulseFlush(const PlayfieldView& view, uint32_t pixels);
+#endif
   void refreshOverlayTexts();
   void updateBoardLayout();
   void updateHudLayout();
@@ -174,20 +568,109 @@ private:
   void markHudDirty();
   void markOverlayDirty();
   void markCellDirty(int gx, int gy);
+  void markCursorDirty();
   void markBoardFrameDirty();
   void markRectDirty(int x, int y, int w, int h);
   void invalidatePlayingScreen();
+  // Add to the dirty area of whichever side draws; with SOKOBAN_GRID_FLUSH the board part
+  // goes to `dirtyCells`.
+  void addDirtyRect(int x0, int y0, int x1, int y1);
+  void invalidateDirty();
   void flushDirty();
-  void buildSpritePixels();
+#if SOKOBAN_BUDGETED_FLUSH
+  // Flushes repaint chunks from `frontView` until `FLUSH_BUDGET_US` is spent.
+  void flushRepaintSlice();
+#endif
+  void captureView(PlayfieldView& view) const;
+  void renderView(const PlayfieldView& view);
+  // Target the region flushes push to: the signature cache when enabled, else the panel.
+  IRenderTarget& flushTarget();
+  // Closes a flush for the push counters; call after every `flusher.flush()`.
+  void finishFlush();
+  void applySpriteSlots(const PlayfieldView& view);
+#if SOKOBAN_LATENCY_PROBE
+  void reportLatency();
+#endif
+  // Returns once nothing queued for the render task is left to draw and hands the display
+  // back to the logic loop. Call before drawing outside the playfield flush.
+  void waitForRenderIdle();
+  // Forgets the board layout of the dirty area, so screens other than the playfield get every
+  // rect they mark flushed whole. The next playfield repaint sets the layout again.
+  void clearBoardGeometry();
+#if SOKOBAN_DUAL_CORE
+  void publishFrame();
+  bool renderNextFrame();
+  static void renderTaskMain(void* ctx);
+#endif
+  template <SpriteVariant V>
+  static const uint8_t* spritePixels();
   void initSpriteSlots();
+  // Points the sprite pixels at art `size` square, rasterizing into the caches unless it is
+  // the flash art's size. A size change first waits for the render task, whose queued frames
+  // still point into the caches.
+  void bindSpriteArt(int size);
+  // Builds every target marker frame for `size` square cells unless already built; like
+  // `bindSpriteArt()`, waits for the render task before rebuilding.
+  void bindTargetRings(int size);
   void syncSpritesFromBoard();
-  int boardPixelWidth() const;
-  int boardPixelHeight() const;
-  int spriteInset() const;
-  uint16_t pixelAt(int x, int y) const;
-  uint16_t hudPixelAt(int x, int y) const;
-  uint16_t boardPixelAt(int x, int y) const;
-  uint16_t cellPixelAt(char cell, int gx, int gy, int lx, int ly) const;
-  uint16_t overlayPixelAt(int x, int y) const;
-  void renderRegionToBuffer(int x0, int y0, int w, int h, uint16_t* buf);
+  void syncPlayerSprite();
+  // Switches the playfield renderer to one specialised on a W x H panel, so screen bounds and
+  // the HUD/board split fold to constants in the per-pixel loop. Returns false and keeps the
+  // current renderer when the render target reports a different size.
+  template <int W, int H>
+  bool useFixedPanel();
 };
+
+template <int W, int H>
+bool SokobanGame::useFixedPanel() {
+  static_assert(W > 0 && H > 0, "fixed panel size must be positive");
+  if (renderTarget.width() != W || renderTarget.height() != H) {
+    return false;
+  }
+  regionRenderer = &PlayfieldView::renderRegion<W, H>;
+  return true;
+}
+
+template <int W, int H>
+void SokobanGame::PlayfieldView::renderRegion(
+  const SpriteGrid& sprites, int x0, int y0, int w, int h, uint16_t* buf) const {
+  const int panelW = (W > 0) ? W : screenW;
+  const int panelH = (H > 0) ? H : screenH;
+  const int xs = (x0 > 0) ? x0 : 0;
+  const int xe = (x0 + w < panelW) ? x0 + w : panelW;
+
+  for (int yy = 0; yy < h; yy++) {
+    int y = y0 + yy;
+    uint16_t* row = buf + yy * w;
+    if (y < 0 || y >= panelH || xs >= xe) {
+      PixelFill::fill(row, w, colors[Theme::BG]);
+      continue;
+    }
+    PixelFill::fill(row, xs - x0, colors[Theme::BG]);
+    if (y < HUD_H) {
+      hudRow(y, xs, xe, row + (xs - x0));
+    } else {
+      viewport.boardRow(colors, y, xs, xe, row + (xs - x0));
+    }
+    PixelFill::fill(row + (xe - x0), x0 + w - xe, colors[Theme::BG]);
+  }
+
+  sprites.renderRegion(x0, y0, w, h, buf);
+
+  if (boxSelected) {
+    viewport.drawCellOutline(selectedX, selectedY, colors[Theme::PLAYER_HI], x0, y0, w, h, buf);
+  }
+  if (cursorActive) {
+    viewport.drawCellOutline(cursorX, cursorY, colors[Theme::ACCENT], x0, y0, w, h, buf);
+  }
+
+  if (levelSolved) {
+    const int ox0 = (x0 > overlayX0) ? x0 : overlayX0;
+    const int ox1 = (x0 + w < overlayX0 + overlayW) ? x0 + w : overlayX0 + overlayW;
+    const int oy0 = (y0 > overlayY0) ? y0 : overlayY0;
+    const int oy1 = (y0 + h < overlayY0 + OVERLAY_H) ? y0 + h : overlayY0 + OVERLAY_H;
+    for (int y = oy0; y < oy1 && ox0 < ox1; y++) {
+      overlayRow(y, ox0, ox1, buf + (y - y0) * w + (ox0 - x0));
+    }
+  }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// Generated by tools/level_pack from tools/builtin_levels.xsb; do not edit by hand.
+namespace SokobanLevels {
+
+inline constexpr uint8_t PACK[] = {
+  0x53, 0x4b, 0x50, 0x32, 0x0a, 0x00, 0xdf, 0x00, 0x57, 0x16, 0x54, 0x9f,
+  0x20, 0x00, 0x2a, 0x00, 0x3f, 0x00, 0x50, 0x00, 0x65, 0x00, 0x7d, 0x00,
+  0x91, 0x00, 0xa3, 0x00, 0xba, 0x00, 0xcf, 0x00, 0x05, 0x03, 0x01, 0x00,
+  0x01, 0x00, 0x3f, 0x9d, 0x7e, 0x00, 0x09, 0x06, 0x29, 0x00, 0x0d, 0x00,
+  0xc0, 0xc7, 0xc1, 0x03, 0xf0, 0x72, 0x32, 0x24, 0x08, 0x90, 0x21, 0x81,
+  0xa0, 0x14, 0x7f, 0x08, 0x06, 0x17, 0x00, 0x07, 0x00, 0x6f, 0x37, 0x09,
+  0x44, 0xae, 0xc9, 0xcd, 0x0f, 0x90, 0x8b, 0x0f, 0x08, 0x07, 0x19, 0x00,
+  0x06, 0x00, 0x78, 0x42, 0x4e, 0x82, 0x40, 0x13, 0x1e, 0xb0, 0x0e, 0x09,
+  0xa0, 0x09, 0xc9, 0xcd, 0x1b, 0x0c, 0x06, 0x6b, 0x00, 0x1d, 0x00, 0x3f,
+  0xf8, 0xb9, 0x78, 0x38, 0x48, 0xb0, 0x9d, 0xa4, 0x09, 0x86, 0x48, 0x3a,
+  0x48, 0x0e, 0x5e, 0x8f, 0x00, 0x06, 0x07, 0x21, 0x00, 0x08, 0x00, 0x1f,
+  0x40, 0xa0, 0x00, 0x01, 0x3e, 0x58, 0x20, 0x01, 0x86, 0x04, 0x78, 0x02,
+  0x00, 0x06, 0x07, 0x10, 0x00, 0x03, 0x00, 0x4f, 0x17, 0x09, 0x52, 0x24,
+  0x18, 0x91, 0x40, 0x44, 0x72, 0xf1, 0x04, 0x07, 0x08, 0x1a, 0x00, 0x06,
+  0x00, 0x5f, 0x27, 0x09, 0x34, 0x21, 0xc1, 0x34, 0x24, 0xd0, 0x84, 0x04,
+  0xd3, 0x90, 0x00, 0x05, 0xbe, 0x00, 0x06, 0x07, 0x1e, 0x00, 0x0a, 0x00,
+  0x2f, 0x88, 0x80, 0x87, 0x6e, 0x78, 0x38, 0x08, 0x12, 0x20, 0x40, 0xa2,
+  0x1c, 0x3c, 0x00, 0x0b, 0x08, 0x59, 0x00, 0x15, 0x00, 0x37, 0x2f, 0x37,
+  0x11, 0x90, 0x9b, 0x28, 0xf8, 0x52, 0x90, 0xa0, 0x18, 0x86, 0x21, 0x41,
+  0x10, 0x04, 0x1f, 0x47, 0x01, 0xde, 0x00,
+};
+
+}  // namespace SokobanLevels
@@ -0,0 +1,19 @@
+#include "SokobanLevels.h"
+
+namespace SokobanLevels {
+
+static_assert(LEVEL_COUNT > 0, "the built-in level pack is empty");
+
+bool load(uint8_t index, SokobanRules::Board& board, int& width, int& height) {
+  return LevelPack::decode(PACK, PACK_BYTES, index, board, width, height);
+}
+
+bool par(uint8_t index, uint16_t& moves, uint16_t& pushes) {
+  return LevelPack::par(PACK, PACK_BYTES, index, moves, pushes);
+}
+
+bool verifyPack() {
+  return LevelPack::verify(PACK, PACK_BYTES);
+}
+
+}  // namespace SokobanLevels
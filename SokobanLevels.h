@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LevelPack.h"
+#include "SokobanLevelPack.h"
+#include "SokobanRules.h"
+
+// Built-in level set, kept in flash as a LevelPack image. `SokobanLevelPack.h` is generated
+// from tools/builtin_levels.xsb by tools/level_pack.
+namespace SokobanLevels {
+
+constexpr uint8_t LEVEL_COUNT = PACK[LevelPack::COUNT_OFFSET];
+constexpr size_t PACK_BYTES = sizeof(PACK);
+
+// Decodes level `index` straight into `board`; cells outside the level are floor. Returns
+// false for a bad index or a malformed pack.
+bool load(uint8_t index, SokobanRules::Board& board, int& width, int& height);
+
+// Move- and push-optimal solution lengths from the pack; 0 when unknown.
+bool par(uint8_t index, uint16_t& moves, uint16_t& pushes);
+
+// Checks the pack header and CRC.
+bool verifyPack();
+
+}  // namespace SokobanLevels
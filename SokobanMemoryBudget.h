@@ -0,0 +1,26 @@
+#pragma once
+
+// RAM budget for the game object, sized for the smallest board the sketch supports (UNO Q).
+// The game knows nothing about the selected hardware preset, so every build is held to the
+// same limits: any feature that grows `SokobanGame` past them fails the build here instead of
+// at runtime on the tightest board.
+
+#include <stddef.h>
+
+#include "SokobanMemoryReport.h"
+
+struct SokobanMemoryBudget {
+  size_t gameBytes;
+  size_t regionBufBytes;
+  size_t spriteBytes;
+};
+
+constexpr SokobanMemoryBudget SOKOBAN_MEMORY_BUDGET = {32u * 1024u, 8u * 1024u, 3u * 1024u};
+
+static_assert(SokobanMemoryReport::GAME_BYTES <= SOKOBAN_MEMORY_BUDGET.gameBytes,
+              "SokobanGame exceeds the RAM budget");
+static_assert(SokobanMemoryReport::REGION_BUF_BYTES <= SOKOBAN_MEMORY_BUDGET.regionBufBytes,
+              "regionBuf exceeds the region buffer budget");
+static_assert(SokobanMemoryReport::SPRITE_GRID_BYTES + SokobanMemoryReport::SPRITE_CACHE_BYTES <=
+                SOKOBAN_MEMORY_BUDGET.spriteBytes,
+              "sprite storage exceeds the sprite budget");
@@ -0,0 +1,46 @@
+#include "SokobanMemoryReport.h"
+#include "SokobanMemoryBudget.h"
+
+#include <Arduino.h>
+
+namespace {
+
+void printLine(Print& out, const char* name, size_t bytes) {
+  out.print(name);
+  out.print(": ");
+  out.print((unsigned long)bytes);
+  out.println(" B");
+}
+
+}  // namespace
+
+void SokobanMemoryReport::print(Print& out) {
+  out.println("[mem] SokobanGame footprint");
+  printLine(out, "  total", GAME_BYTES);
+  printLine(out, "  board", BOARD_BYTES);
+  printLine(out, "  input", INPUT_BYTES);
+  printLine(out, "  scenes", SCENE_BYTES);
+  printLine(out, "  texts", TEXT_BYTES);
+  printLine(out, "  ProgressStore", PROGRESS_BYTES);
+  printLine(out, "  PathFinder", PATH_FINDER_BYTES);
+  printLine(out, "  ghost runs", GHOST_RUN_BYTES);
+  printLine(out, "  PushPlanner", PUSH_PLANNER_BYTES);
+  printLine(out, "  regionBuf", REGION_BUF_BYTES);
+  printLine(out, "  SpriteGrid", SPRITE_GRID_BYTES);
+  printLine(out, "  sprite cache", SPRITE_CACHE_BYTES);
+  printLine(out, "  target rings", TARGET_RING_BYTES);
+  printLine(out, "  DirtyRects", DIRTY_RECTS_BYTES);
+  printLine(out, "  TileFlusher", TILE_FLUSHER_BYTES);
+  printLine(out, "  dirty cells", DIRTY_CELLS_BYTES);
+  printLine(out, "  render views", RENDER_VIEW_BYTES);
+  printLine(out, "  tile signatures", TILE_SIGNATURE_BYTES);
+  printLine(out, "  LevelGenerator", GENERATOR_BYTES);
+  printLine(out, "  repaint schedule", REPAINT_SCHEDULE_BYTES);
+  printLine(out, "  latency probe", LATENCY_PROBE_BYTES);
+  printLine(out, "  race", RACE_BYTES);
+  out.println("[mem] static tables");
+  printLine(out, "  level pack", LEVEL_PACK_BYTES);
+  printLine(out, "  sprite art", SPRITE_ART_BYTES);
+  out.println(SokobanLevels::verifyPack() ? "[mem] level pack CRC ok"
+                                          : "[mem] level pack CRC BAD");
+}
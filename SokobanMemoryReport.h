@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "SokobanGame.h"
+
+class Print;
+
+// Compile-time view of where `SokobanGame` RAM goes, grouped by subsystem.
+// `SokobanMemoryBudget.h` checks these against the RAM budget.
+struct SokobanMemoryReport {
+  using G = SokobanGame;
+
+  static constexpr size_t GAME_BYTES = sizeof(SokobanGame);
+
+  static constexpr size_t BOARD_BYTES =
+    sizeof(G::viewport) + sizeof(G::playerX) + sizeof(G::playerY) + sizeof(G::remainingCrates);
+  static constexpr size_t INPUT_BYTES =
+    sizeof(ButtonSet) + sizeof(PressReleaseAction);
+  static constexpr size_t SCENE_BYTES =
+    sizeof(SceneSwitcher) + sizeof(TitleScene) + sizeof(LevelSelectScene) +
+    sizeof(PlayingScene) + sizeof(GameOverScene);
+  static constexpr size_t TEXT_BYTES =
+    sizeof(G::hudLevelText) + sizeof(G::hudMovesText) + sizeof(G::hudTotalText) +
+    sizeof(G::hudStatusText) + sizeof(G::hudParMask) + sizeof(G::hudTimerText) +
+    sizeof(G::timerGlyphs) + sizeof(G::overlayTitleText) + sizeof(G::overlaySubText);
+  static constexpr size_t PROGRESS_BYTES = sizeof(ProgressStore);
+  static constexpr size_t PATH_FINDER_BYTES = sizeof(PathFinder);
+  static constexpr size_t PUSH_PLANNER_BYTES = sizeof(PushPlanner);
+  static constexpr size_t REGION_BUF_BYTES = sizeof(G::regionBuf);
+  static constexpr size_t SPRITE_GRID_BYTES = sizeof(SpriteGrid);
+#if SOKOBAN_GHOST
+  static constexpr size_t SPRITE_CACHE_BYTES =
+    sizeof(G::boxSpriteCache) + sizeof(G::playerSpriteCache) + sizeof(G::ghostSpriteCache);
+  static constexpr size_t GHOST_RUN_BYTES = sizeof(G::runLog) + sizeof(G::bestRuns);
+#else
+  static constexpr size_t SPRITE_CACHE_BYTES =
+    sizeof(G::boxSpriteCache) + sizeof(G::playerSpriteCache);
+  static constexpr size_t GHOST_RUN_BYTES = 0;
+#endif
+  static constexpr size_t TARGET_RING_BYTES = sizeof(G::targetRings);
+  static constexpr size_t DIRTY_RECTS_BYTES = sizeof(DirtyRects);
+  static constexpr size_t TILE_FLUSHER_BYTES = sizeof(TileFlusher);
+#if SOKOBAN_GRID_FLUSH
+  static constexpr size_t DIRTY_CELLS_BYTES = sizeof(DirtyCellMap);
+#else
+  static constexpr size_t DIRTY_CELLS_BYTES = 0;
+#endif
+#if SOKOBAN_TILE_SIGNATURES
+  static constexpr size_t TILE_SIGNATURE_BYTES = sizeof(TileSignatureCache);
+#else
+  static constexpr size_t TILE_SIGNATURE_BYTES = 0;
+#endif
+#if SOKOBAN_ENDLESS
+  static constexpr size_t GENERATOR_BYTES = sizeof(LevelGenerator);
+#else
+  static constexpr size_t GENERATOR_BYTES = 0;
+#endif
+#if SOKOBAN_BUDGETED_FLUSH
+  static constexpr size_t REPAINT_SCHEDULE_BYTES = sizeof(RepaintSchedule);
+#else
+  static constexpr size_t REPAINT_SCHEDULE_BYTES = 0;
+#endif
+#if SOKOBAN_LATENCY_PROBE
+  static constexpr size_t LATENCY_PROBE_BYTES = sizeof(LatencyProbe);
+#else
+  static constexpr size_t LATENCY_PROBE_BYTES = 0;
+#endif
+#if SOKOBAN_RACE
+  static constexpr size_t RACE_BYTES = sizeof(RaceScene) + sizeof(G::rivalProfile) +
+    sizeof(G::rivalInputSet) + sizeof(ButtonSet) + sizeof(PressReleaseAction);
+#else
+  static constexpr size_t RACE_BYTES = 0;
+#endif
+#if SOKOBAN_DUAL_CORE
+  static constexpr size_t RENDER_VIEW_BYTES = sizeof(G::renderQueue);
+#else
+  static constexpr size_t RENDER_VIEW_BYTES = sizeof(G::frontView);
+#endif
+
+  static constexpr size_t LEVEL_PACK_BYTES = SokobanLevels::PACK_BYTES;
+  // Box and player bitmaps are constexpr tables in flash, not game RAM.
+  static constexpr size_t SPRITE_ART_BYTES = sizeof(SpriteArt::Bitmap<G::SPRITE_SIZE>) * 2;
+
+  static void print(Print& out);
+};
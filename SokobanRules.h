@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+// Board format and cell rules shared by the game, the path finders and host tools.
+// Cells use the XSB symbols: '#' wall, ' ' floor, '.' target, '$' box, '*' box on target,
+// '@' player, '+' player on target.
+namespace SokobanRules {
+
+constexpr int BOARD_MAX_W = 14;
+constexpr int BOARD_MAX_H = 10;
+constexpr int BOARD_MAX_CELLS = BOARD_MAX_W * BOARD_MAX_H;
+
+using Board = char[BOARD_MAX_H][BOARD_MAX_W];
+
+enum Dir : uint8_t {
+  DIR_LEFT = 0,
+  DIR_RIGHT = 1,
+  DIR_UP = 2,
+  DIR_DOWN = 3,
+};
+
+constexpr int DIR_COUNT = 4;
+constexpr int DIR_DX[DIR_COUNT] = {-1, 1, 0, 0};
+constexpr int DIR_DY[DIR_COUNT] = {0, 0, -1, 1};
+
+constexpr bool isBox(char cell) {
+  return cell == '$' || cell == '*';
+}
+
+constexpr bool isTarget(char cell) {
+  return cell == '.' || cell == '*' || cell == '+';
+}
+
+constexpr bool isFreeForPlayer(char cell) {
+  return cell == ' ' || cell == '.';
+}
+
+constexpr bool isFreeForBox(char cell) {
+  return cell == ' ' || cell == '.';
+}
+
+// Cell symbol after a box or the player enters/leaves it; other symbols are returned as-is.
+constexpr char withBox(char cell) {
+  return cell == ' ' ? '$' : (cell == '.' ? '*' : cell);
+}
+
+constexpr char withoutBox(char cell) {
+  return cell == '$' ? ' ' : (cell == '*' ? '.' : cell);
+}
+
+constexpr char withPlayer(char cell) {
+  return cell == ' ' ? '@' : (cell == '.' ? '+' : cell);
+}
+
+constexpr char withoutPlayer(char cell) {
+  return cell == '@' ? ' ' : (cell == '+' ? '.' : cell);
+}
+
+}  // namespace SokobanRules
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sprite bitmaps produced at compile time. Generators describe the art in a 16x16 design
+// space in `Theme::Color` indices and return 0 for transparent pixels; `generate<N>()`
+// rasterizes them into a constexpr bitmap that the compiler places in read-only flash.
+namespace SpriteArt {
+
+constexpr int DESIGN_SIZE = 16;
+
+template <int N>
+struct Bitmap {
+  uint8_t pixels[N * N]{};
+};
+
+struct BoxColors {
+  uint8_t body;
+  uint8_t hi;
+  uint8_t shadow;
+  uint8_t mark;
+};
+
+struct PlayerColors {
+  uint8_t body;
+  uint8_t hi;
+  uint8_t shadow;
+};
+
+constexpr uint8_t boxPixel(const BoxColors& c, int x, int y) {
+  if (x < 2 || x > 13 || y < 2 || y > 13) {
+    return 0;
+  }
+  bool crossV = (x == 7 || x == 8) && y >= 5 && y <= 10;
+  bool crossH = (y == 7 || y == 8) && x >= 5 && x <= 10;
+  if (crossV || crossH) {
+    return c.mark;
+  }
+  if (y <= 3 || x <= 3) {
+    return c.hi;
+  }
+  if (y >= 12 || x >= 12) {
+    return c.shadow;
+  }
+  return c.body;
+}
+
+constexpr uint8_t playerPixel(const PlayerColors& c, int x, int y) {
+  // The figure is drawn one row up so the feet end on the last sprite row.
+  int py = y + 1;
+  if (py >= 1 && py <= 5 && x >= 5 && x <= 10) {
+    return (py <= 2 || x <= 5) ? c.hi : c.body;
+  }
+  if (py >= 6 && py <= 11 && x >= 4 && x <= 11) {
+    return (x <= 5 || py <= 7) ? c.hi : c.body;
+  }
+  if (py >= 12 && py <= 15 && ((x >= 3 && x <= 6) || (x >= 9 && x <= 12))) {
+    return c.shadow;
+  }
+  return 0;
+}
+
+// The player figure with every other pixel left out, so the board shows through it.
+constexpr uint8_t ghostPixel(const PlayerColors& c, int x, int y) {
+  return ((x + y) & 1) != 0 ? 0 : playerPixel(c, x, y);
+}
+
+// Nearest-neighbour samples the design grid at `size`x`size`; usable at runtime for sizes
+// that are only known once the board layout is computed.
+template <class Colors>
+constexpr void rasterize(
+  uint8_t (*pixel)(const Colors&, int, int), const Colors& colors, int size, uint8_t* dst) {
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      dst[y * size + x] = pixel(colors, x * DESIGN_SIZE / size, y * DESIGN_SIZE / size);
+    }
+  }
+}
+
+template <int N, class Colors>
+constexpr Bitmap<N> generate(uint8_t (*pixel)(const Colors&, int, int), const Colors& colors) {
+  Bitmap<N> out{};
+  rasterize(pixel, colors, N, out.pixels);
+  return out;
+}
+
+}  // namespace SpriteArt
@@ -0,0 +1,136 @@
+#include "SpriteGrid.h"
+
+#include <string.h>
+
+using SokobanRules::BOARD_MAX_H;
+using SokobanRules::BOARD_MAX_W;
+
+namespace {
+
+int floorDiv(int a, int b) {
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+int clampInt(int v, int lo, int hi) {
+  return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+}  // namespace
+
+SpriteGrid::SpriteGrid() {
+  clear();
+}
+
+void SpriteGrid::setGeometry(int originXIn, int originYIn, int cellSizeIn) {
+  if (originX == originXIn && originY == originYIn && cellSize == cellSizeIn) {
+    return;
+  }
+  originX = (int16_t)originXIn;
+  originY = (int16_t)originYIn;
+  cellSize = (int16_t)cellSizeIn;
+  clear();
+}
+
+void SpriteGrid::clear() {
+  memset(cellHead, NONE, sizeof(cellHead));
+  for (int i = 0; i < MAX_SPRITES; i++) {
+    next[i] = NONE;
+    slotX[i] = 0;
+    slotY[i] = 0;
+    slotCellX[i] = -1;
+    slotCellY[i] = -1;
+    slotPixels[i] = nullptr;
+  }
+}
+
+void SpriteGrid::setPosition(int slot, int x, int y, const uint8_t* pixels) {
+  slotPixels[slot] = pixels;
+  if (slotCellX[slot] >= 0 && slotX[slot] == x && slotY[slot] == y) {
+    return;
+  }
+  unlink(slot);
+  slotX[slot] = (int16_t)x;
+  slotY[slot] = (int16_t)y;
+  if (cellSize <= 0 || x < originX || y < originY) {
+    return;
+  }
+  const int gx = (x - originX) / cellSize;
+  const int gy = (y - originY) / cellSize;
+  if (gx >= BOARD_MAX_W || gy >= BOARD_MAX_H) {
+    return;
+  }
+  uint8_t* link = &cellHead[gy][gx];
+  while (*link != NONE && *link < slot) {
+    link = &next[*link];
+  }
+  next[slot] = *link;
+  *link = (uint8_t)slot;
+  slotCellX[slot] = (int8_t)gx;
+  slotCellY[slot] = (int8_t)gy;
+}
+
+void SpriteGrid::hide(int slot) {
+  unlink(slot);
+}
+
+void SpriteGrid::setPalette(const uint16_t* colors) {
+  palette = colors;
+}
+
+void SpriteGrid::unlink(int slot) {
+  if (slotCellX[slot] < 0) {
+    return;
+  }
+  uint8_t* link = &cellHead[slotCellY[slot]][slotCellX[slot]];
+  while (*link != slot) {
+    link = &next[*link];
+  }
+  *link = next[slot];
+  next[slot] = NONE;
+  slotCellX[slot] = -1;
+  slotCellY[slot] = -1;
+}
+
+void SpriteGrid::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+  if (cellSize <= 0 || w <= 0 || h <= 0) {
+    return;
+  }
+  // A sprite that is not cell-aligned reaches into the next cell, so the scan starts one
+  // cell left of and above the region.
+  const int cx0 = clampInt(floorDiv(x0 - originX, cellSize) - 1, 0, BOARD_MAX_W - 1);
+  const int cy0 = clampInt(floorDiv(y0 - originY, cellSize) - 1, 0, BOARD_MAX_H - 1);
+  const int cx1 = floorDiv(x0 + w - 1 - originX, cellSize);
+  const int cy1 = floorDiv(y0 + h - 1 - originY, cellSize);
+  if (cx1 < 0 || cy1 < 0) {
+    return;
+  }
+  for (int cy = cy0; cy <= cy1 && cy < BOARD_MAX_H; cy++) {
+    for (int cx = cx0; cx <= cx1 && cx < BOARD_MAX_W; cx++) {
+      for (uint8_t s = cellHead[cy][cx]; s != NONE; s = next[s]) {
+        blit(s, x0, y0, w, h, buf);
+      }
+    }
+  }
+}
+
+void SpriteGrid::blit(int slot, int x0, int y0, int w, int h, uint16_t* buf) const {
+  const uint8_t* pixels = slotPixels[slot];
+  if (pixels == nullptr) {
+    return;
+  }
+  const int sx = slotX[slot];
+  const int sy = slotY[slot];
+  const int xs = (sx > x0) ? sx : x0;
+  const int xe = (sx + cellSize < x0 + w) ? sx + cellSize : x0 + w;
+  const int ys = (sy > y0) ? sy : y0;
+  const int ye = (sy + cellSize < y0 + h) ? sy + cellSize : y0 + h;
+  for (int y = ys; y < ye; y++) {
+    const uint8_t* src = pixels + (y - sy) * cellSize + (xs - sx);
+    uint16_t* dst = buf + (y - y0) * w + (xs - x0);
+    for (int x = xs; x < xe; x++, src++, dst++) {
+      if (*src != 0) {
+        *dst = palette[*src];
+      }
+    }
+  }
+}
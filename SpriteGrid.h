@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SokobanRules.h"
+
+// Square cell-sized sprites indexed by the board cell under their top-left corner, so a region
+// render only visits the cells it overlaps instead of every sprite slot. Each cell heads a
+// short list of slots, kept in slot order: sprites sharing a cell are drawn lowest slot
+// first, so higher slots cover lower ones. Pixels are palette indices resolved at blit time;
+// index 0 is transparent. Sprites whose corner lies off the board are not drawn.
+class SpriteGrid {
+public:
+  static constexpr int MAX_SPRITES = 24;
+
+  SpriteGrid();
+
+  // Board origin and cell size in pixels; sprites are `cellSize` square. A change drops every
+  // sprite, which the caller then places again.
+  void setGeometry(int originX, int originY, int cellSize);
+  void clear();
+  // Moves (or shows) `slot` with its top-left corner at pixel (x, y).
+  void setPosition(int slot, int x, int y, const uint8_t* pixels);
+  void hide(int slot);
+  // RGB565 colour of each pixel index; must be set before the first render.
+  void setPalette(const uint16_t* colors);
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
+
+private:
+  static constexpr uint8_t NONE = 0xFF;
+
+  int16_t originX = 0;
+  int16_t originY = 0;
+  int16_t cellSize = 0;
+  // First slot in each cell's list, and each slot's successor; NONE ends a list.
+  uint8_t cellHead[SokobanRules::BOARD_MAX_H][SokobanRules::BOARD_MAX_W];
+  uint8_t next[MAX_SPRITES];
+  int16_t slotX[MAX_SPRITES];
+  int16_t slotY[MAX_SPRITES];
+  // Indexed cell of each slot, or -1 while hidden or off the board.
+  int8_t slotCellX[MAX_SPRITES];
+  int8_t slotCellY[MAX_SPRITES];
+  const uint8_t* slotPixels[MAX_SPRITES];
+  const uint16_t* palette = nullptr;
+
+  void unlink(int slot);
+  void blit(int slot, int x0, int y0, int w, int h, uint16_t* buf) const;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+// Row spans of a target marker in a `size` square cell: for each cell row, the half-width
+// around the centre column of the outer disc, the inner disc and the hole, or -1 where the
+// row misses that circle. Built once per tile size, so drawing a target row is a lookup
+// instead of solving dx * dx + dy * dy <= r * r.
+struct TargetRing {
+  static constexpr int MAX_SIZE = 20;
+
+  int8_t outer[MAX_SIZE];
+  int8_t inner[MAX_SIZE];
+  int8_t hole[MAX_SIZE];
+  // Outer radius: the marker lies within this many pixels of the centre on both axes.
+  int8_t reach;
+
+  // The static marker's radii less `shrink` pixels each, kept at least 3, 2 and 1.
+  void build(int size, int shrink) {
+    int outerR = size / 2 - 3 - shrink;
+    int innerR = size / 2 - 5 - shrink;
+    int holeR = size / 2 - 7 - shrink;
+    outerR = (outerR < 3) ? 3 : outerR;
+    innerR = (innerR < 2) ? 2 : innerR;
+    holeR = (holeR < 1) ? 1 : holeR;
+    const int c = size / 2;
+    for (int ly = 0; ly < size && ly < MAX_SIZE; ly++) {
+      const int dy2 = (ly - c) * (ly - c);
+      outer[ly] = halfWidth(outerR, dy2);
+      inner[ly] = halfWidth(innerR, dy2);
+      hole[ly] = halfWidth(holeR, dy2);
+    }
+    reach = (int8_t)outerR;
+  }
+
+private:
+  static int8_t halfWidth(int r, int dy2) {
+    int d = -1;
+    while ((d + 1) * (d + 1) + dy2 <= r * r) {
+      d++;
+    }
+    return (int8_t)d;
+  }
+};
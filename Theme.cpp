@@ -0,0 +1,125 @@
+#include "Theme.h"
+
+#include "SGF/Color565.h"
+
+namespace {
+
+// One entry per `Theme::Color`, in enum order.
+constexpr uint16_t CLASSIC[] = {
+  0,                               // TRANSPARENT
+  Color565::rgb(8, 12, 18),        // BG
+  Color565::rgb(14, 22, 32),       // PANEL
+  Color565::rgb(42, 64, 82),       // PANEL_LINE
+  Color565::rgb(228, 236, 244),    // TEXT
+  Color565::rgb(140, 160, 176),    // TEXT_DIM
+  Color565::rgb(255, 196, 96),     // ACCENT
+  Color565::rgb(54, 74, 98),       // WALL
+  Color565::rgb(86, 116, 150),     // WALL_HI
+  Color565::rgb(30, 42, 58),       // WALL_SH
+  Color565::rgb(18, 26, 34),       // FLOOR_A
+  Color565::rgb(14, 22, 30),       // FLOOR_B
+  Color565::rgb(24, 36, 46),       // GRID
+  Color565::rgb(255, 40, 40),      // TARGET
+  Color565::rgb(255, 160, 160),    // TARGET_HI
+  Color565::rgb(188, 136, 72),     // BOX
+  Color565::rgb(236, 188, 108),    // BOX_HI
+  Color565::rgb(120, 84, 44),      // BOX_SH
+  Color565::rgb(92, 220, 148),     // PLAYER
+  Color565::rgb(156, 255, 196),    // PLAYER_HI
+  Color565::rgb(44, 122, 78),      // PLAYER_SH
+  Color565::rgb(120, 150, 172),    // GHOST
+  Color565::rgb(20, 28, 40),       // OVERLAY
+  Color565::rgb(14, 8, 10),        // GO_BG
+  Color565::rgb(180, 24, 24),      // GO_LINE
+  Color565::rgb(255, 48, 48),      // GO_TITLE
+};
+
+// Black ground, white lines and text, saturated pieces far apart in brightness.
+constexpr uint16_t HIGH_CONTRAST[] = {
+  0,                               // TRANSPARENT
+  Color565::rgb(0, 0, 0),          // BG
+  Color565::rgb(0, 0, 0),          // PANEL
+  Color565::rgb(255, 255, 255),    // PANEL_LINE
+  Color565::rgb(255, 255, 255),    // TEXT
+  Color565::rgb(200, 200, 200),    // TEXT_DIM
+  Color565::rgb(255, 224, 0),      // ACCENT
+  Color565::rgb(150, 150, 160),    // WALL
+  Color565::rgb(235, 235, 240),    // WALL_HI
+  Color565::rgb(80, 80, 88),       // WALL_SH
+  Color565::rgb(0, 0, 0),          // FLOOR_A
+  Color565::rgb(16, 16, 16),       // FLOOR_B
+  Color565::rgb(56, 56, 56),       // GRID
+  Color565::rgb(255, 0, 255),      // TARGET
+  Color565::rgb(255, 170, 255),    // TARGET_HI
+  Color565::rgb(255, 160, 0),      // BOX
+  Color565::rgb(255, 220, 120),    // BOX_HI
+  Color565::rgb(150, 86, 0),       // BOX_SH
+  Color565::rgb(0, 224, 255),      // PLAYER
+  Color565::rgb(190, 250, 255),    // PLAYER_HI
+  Color565::rgb(0, 112, 140),      // PLAYER_SH
+  Color565::rgb(170, 170, 170),    // GHOST
+  Color565::rgb(0, 0, 0),          // OVERLAY
+  Color565::rgb(0, 0, 0),          // GO_BG
+  Color565::rgb(255, 224, 0),      // GO_LINE
+  Color565::rgb(255, 255, 255),    // GO_TITLE
+};
+
+// Classic ground with pieces from the Okabe-Ito set, so targets, boxes and the player never
+// rely on a red/green difference.
+constexpr uint16_t COLOR_BLIND[] = {
+  0,                               // TRANSPARENT
+  Color565::rgb(8, 12, 18),        // BG
+  Color565::rgb(14, 22, 32),       // PANEL
+  Color565::rgb(42, 64, 82),       // PANEL_LINE
+  Color565::rgb(228, 236, 244),    // TEXT
+  Color565::rgb(140, 160, 176),    // TEXT_DIM
+  Color565::rgb(240, 228, 66),     // ACCENT
+  Color565::rgb(54, 74, 98),       // WALL
+  Color565::rgb(86, 116, 150),     // WALL_HI
+  Color565::rgb(30, 42, 58),       // WALL_SH
+  Color565::rgb(18, 26, 34),       // FLOOR_A
+  Color565::rgb(14, 22, 30),       // FLOOR_B
+  Color565::rgb(24, 36, 46),       // GRID
+  Color565::rgb(86, 180, 233),     // TARGET
+  Color565::rgb(184, 226, 250),    // TARGET_HI
+  Color565::rgb(230, 159, 0),      // BOX
+  Color565::rgb(250, 204, 96),     // BOX_HI
+  Color565::rgb(146, 100, 0),      // BOX_SH
+  Color565::rgb(204, 121, 167),    // PLAYER
+  Color565::rgb(236, 184, 212),    // PLAYER_HI
+  Color565::rgb(128, 70, 104),     // PLAYER_SH
+  Color565::rgb(150, 162, 180),    // GHOST
+  Color565::rgb(20, 28, 40),       // OVERLAY
+  Color565::rgb(14, 8, 10),        // GO_BG
+  Color565::rgb(213, 94, 0),       // GO_LINE
+  Color565::rgb(240, 130, 40),     // GO_TITLE
+};
+
+static_assert(sizeof(CLASSIC) / sizeof(CLASSIC[0]) == Theme::COLOR_COUNT, "classic palette");
+static_assert(sizeof(HIGH_CONTRAST) / sizeof(HIGH_CONTRAST[0]) == Theme::COLOR_COUNT,
+              "high contrast palette");
+static_assert(sizeof(COLOR_BLIND) / sizeof(COLOR_BLIND[0]) == Theme::COLOR_COUNT,
+              "colour-blind palette");
+
+}  // namespace
+
+const uint16_t* Theme::palette(Id id) {
+  switch (id) {
+    case Id::HighContrast: return HIGH_CONTRAST;
+    case Id::ColorBlind: return COLOR_BLIND;
+    default: return CLASSIC;
+  }
+}
+
+const char* Theme::name(Id id) {
+  switch (id) {
+    case Id::HighContrast: return "KONTRAST";
+    case Id::ColorBlind: return "DALTONIZM";
+    default: return "KLASYCZNY";
+  }
+}
+
+Theme::Id Theme::cycle(Id id, int step) {
+  int next = ((int)id + step) % THEME_COUNT;
+  return (Id)((next < 0) ? next + THEME_COUNT : next);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+// Semantic colour indices and the RGB565 palettes that resolve them. Everything on screen,
+// sprite bitmaps included, is described in these indices; switching theme swaps the palette
+// pointer and repaints, without touching any stored art. Index 0 is the transparent sprite
+// pixel and has no colour of its own.
+namespace Theme {
+
+enum Color : uint8_t {
+  TRANSPARENT = 0,
+  BG,
+  PANEL,
+  PANEL_LINE,
+  TEXT,
+  TEXT_DIM,
+  ACCENT,
+  WALL,
+  WALL_HI,
+  WALL_SH,
+  FLOOR_A,
+  FLOOR_B,
+  GRID,
+  TARGET,
+  TARGET_HI,
+  BOX,
+  BOX_HI,
+  BOX_SH,
+  PLAYER,
+  PLAYER_HI,
+  PLAYER_SH,
+  GHOST,
+  OVERLAY,
+  GO_BG,
+  GO_LINE,
+  GO_TITLE,
+  COLOR_COUNT
+};
+
+enum class Id : uint8_t {
+  Classic,
+  HighContrast,
+  ColorBlind,
+};
+
+constexpr int THEME_COUNT = 3;
+
+// `COLOR_COUNT` entries in flash, indexed by `Color`.
+const uint16_t* palette(Id id);
+// Upper-case label for the title screen.
+const char* name(Id id);
+// The next (step 1) or previous (step -1) theme, wrapping around.
+Id cycle(Id id, int step);
+
+}  // namespace Theme
@@ -0,0 +1,157 @@
+#include "TileSignatureCache.h"
+
+namespace {
+
+int floorToCell(int v) {
+  int rem = v % TileSignatureCache::CELL;
+  return (rem < 0) ? v - rem - TileSignatureCache::CELL : v - rem;
+}
+
+}  // namespace
+
+TileSignatureCache::TileSignatureCache(IRenderTarget& targetRef) : target(targetRef) {}
+
+int TileSignatureCache::width() const {
+  return target.width();
+}
+
+int TileSignatureCache::height() const {
+  return target.height();
+}
+
+void TileSignatureCache::drawRGB565(int x, int y, int w, int h, const uint16_t* pixels) {
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+  if (floorToCell(x) != x || floorToCell(y) != y || x < 0 || y < 0) {
+    forget(x, y, w, h);
+    target.drawRGB565(x, y, w, h, pixels);
+    framePushed += (uint32_t)w * (uint32_t)h * 2u;
+    return;
+  }
+
+  const int screenW = target.width();
+  const int screenH = target.height();
+  const int cells = (w + CELL - 1) / CELL;
+  for (int by = 0; by < h; by += CELL) {
+    const int bandH = (h - by < CELL) ? h - by : CELL;
+    const bool wholeBand = bandH == CELL || y + by + bandH == screenH;
+    const int row = (y + by) / CELL;
+    const uint16_t* band = pixels + by * w;
+    int runStart = -1;
+
+    // One pass past the last cell closes a run that reaches the right edge.
+    for (int cell = 0; cell <= cells; cell++) {
+      const int bx = cell * CELL;
+      bool changed = false;
+      if (cell < cells) {
+        const int cellW = (w - bx < CELL) ? w - bx : CELL;
+        const int col = (x + bx) / CELL;
+        // A cell cut short by the push (not by the panel edge) cannot be compared later.
+        const bool whole = wholeBand && (cellW == CELL || x + bx + cellW == screenW);
+        uint32_t signature = whole ? cellSignature(band + bx, w, cellW, bandH) : 0;
+        if (row >= MAX_ROWS || col >= MAX_COLS) {
+          changed = true;
+        } else {
+          changed = (signature == 0) || (signatures[row][col] != signature);
+          signatures[row][col] = signature;
+        }
+        if (!changed) {
+          frameSkipped += (uint32_t)cellW * (uint32_t)bandH * 2u;
+        }
+      }
+
+      if (changed && runStart < 0) {
+        runStart = bx;
+      } else if (!changed && runStart >= 0) {
+        int runW = ((bx < w) ? bx : w) - runStart;
+        pushRun(band + runStart, w, x + runStart, y + by, runW, bandH, runW == w);
+        runStart = -1;
+      }
+    }
+  }
+}
+
+void TileSignatureCache::invalidateAll() {
+  for (int row = 0; row < MAX_ROWS; row++) {
+    for (int col = 0; col < MAX_COLS; col++) {
+      signatures[row][col] = 0;
+    }
+  }
+}
+
+void TileSignatureCache::snapToCells(int& x, int& y, int& w, int& h) {
+  int x1 = x + w;
+  int y1 = y + h;
+  x = floorToCell(x);
+  y = floorToCell(y);
+  w = floorToCell(x1 + CELL - 1) - x;
+  h = floorToCell(y1 + CELL - 1) - y;
+}
+
+void TileSignatureCache::endFrame() {
+  lastPushed = framePushed;
+  lastSkipped = frameSkipped;
+  totalSkipped += frameSkipped;
+  framePushed = 0;
+  frameSkipped = 0;
+}
+
+uint32_t TileSignatureCache::lastPushedBytes() const {
+  return lastPushed;
+}
+
+uint32_t TileSignatureCache::lastSkippedBytes() const {
+  return lastSkipped;
+}
+
+uint32_t TileSignatureCache::totalSkippedBytes() const {
+  return totalSkipped;
+}
+
+uint32_t TileSignatureCache::cellSignature(const uint16_t* pixels, int stride, int w, int h) {
+  uint32_t signature = 2166136261u;
+  for (int yy = 0; yy < h; yy++) {
+    const uint16_t* p = pixels + yy * stride;
+    int xx = 0;
+    for (; xx + 1 < w; xx += 2) {
+      signature = (signature ^ ((uint32_t)p[xx] | ((uint32_t)p[xx + 1] << 16))) * 16777619u;
+    }
+    if (xx < w) {
+      signature = (signature ^ p[xx]) * 16777619u;
+    }
+  }
+  return (signature == 0) ? 1u : signature;
+}
+
+void TileSignatureCache::forget(int x, int y, int w, int h) {
+  int col0 = floorToCell(x) / CELL;
+  int row0 = floorToCell(y) / CELL;
+  for (int row = (row0 > 0 ? row0 : 0); row * CELL < y + h && row < MAX_ROWS; row++) {
+    for (int col = (col0 > 0 ? col0 : 0); col * CELL < x + w && col < MAX_COLS; col++) {
+      signatures[row][col] = 0;
+    }
+  }
+}
+
+void TileSignatureCache::pushRun(
+  const uint16_t* pixels, int stride, int x, int y, int w, int h, bool wholeRows) {
+  framePushed += (uint32_t)w * (uint32_t)h * 2u;
+  if (wholeRows) {
+    // The run spans the full push width, so its rows are already contiguous.
+    target.drawRGB565(x, y, w, h, pixels);
+    return;
+  }
+  if (w > MAX_RUN_W) {
+    for (int yy = 0; yy < h; yy++) {
+      target.drawRGB565(x, y + yy, w, 1, pixels + yy * stride);
+    }
+    return;
+  }
+  for (int yy = 0; yy < h; yy++) {
+    for (int xx = 0; xx < w; xx++) {
+      runBuf[yy * w + xx] = pixels[yy * stride + xx];
+    }
+  }
+  target.drawRGB565(x, y, w, h, runBuf);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SGF/IRenderTarget.h"
+
+// Render target proxy that remembers a signature of every 16x16 screen cell it has pushed and
+// drops pushes of cells whose new content matches. Changed cells are forwarded in horizontal
+// runs, so a repaint of a mostly unchanged area only costs the cells that differ on the wire.
+// Signatures are a multiply-xor hash over pixel pairs; each step is a bijection, so a change
+// confined to one pixel pair is always detected.
+class TileSignatureCache : public IRenderTarget {
+public:
+  static constexpr int CELL = 16;
+  static constexpr int MAX_COLS = 20;
+  static constexpr int MAX_ROWS = 20;
+  static constexpr int MAX_RUN_W = 64;
+
+  explicit TileSignatureCache(IRenderTarget& target);
+
+  int width() const override;
+  int height() const override;
+  void drawRGB565(int x, int y, int w, int h, const uint16_t* pixels) override;
+
+  // Forget every signature; call after anything drew to the panel without going through here.
+  void invalidateAll();
+  // Grows a rect to whole cells so every push of it can be checked cell by cell.
+  static void snapToCells(int& x, int& y, int& w, int& h);
+
+  // Closes the current frame's counters; `last*` then describe it.
+  void endFrame();
+  uint32_t lastPushedBytes() const;
+  uint32_t lastSkippedBytes() const;
+  uint32_t totalSkippedBytes() const;
+
+private:
+  IRenderTarget& target;
+  // 0 means unknown; computed signatures are never 0.
+  uint32_t signatures[MAX_ROWS][MAX_COLS]{};
+  uint16_t runBuf[MAX_RUN_W * CELL]{};
+  uint32_t framePushed = 0;
+  uint32_t frameSkipped = 0;
+  uint32_t lastPushed = 0;
+  uint32_t lastSkipped = 0;
+  uint32_t totalSkipped = 0;
+
+  static uint32_t cellSignature(const uint16_t* pixels, int stride, int w, int h);
+  void forget(int x, int y, int w, int h);
+  void pushRun(const uint16_t* pixels, int stride, int x, int y, int w, int h, bool wholeRows);
+};
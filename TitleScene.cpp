@@ -11,9 +11,13 @@ void TitleScene::onEnter() {
 
 void TitleScene::onPhysics(float delta) {
   (void)delta;
-  if (game.fireConfirm.update(game.fireAction)) {
-    game.startNewGame();
-    game.sceneSwitcher.switchTo(game.playingScene);
+  int step = game.buttons.right.justPressed() ? 1 : (game.buttons.left.justPressed() ? -1 : 0);
+  if (step != 0) {
+    game.setTheme(Theme::cycle(game.theme, step));
+    game.renderTitleScreen();
+  }
+  if (game.fireConfirm.update(game.buttons.fire)) {
+    game.sceneSwitcher.switchTo(game.levelSelectScene);
     game.resetClock();
   }
 }
@@ -10,10 +10,13 @@
 // #define SGF_HW_PRESET SGF_HW_PRESET_ESP32_ST7789_240X240
 
 #include "SGFHardwarePresets.h"
+#include "EepromProgressStorage.h"
 #include "SokobanGame.h"
 
 auto hardware = SGFHardwareProfile::makeRuntime();
-SokobanGame sokoban(hardware.renderTarget(), hardware.screen(), hardware.profile);
+EepromProgressStorage progressStorage;
+SokobanGame sokoban(
+  hardware.renderTarget(), hardware.screen(), hardware.profile, progressStorage);
 
 void setup() {
   hardware.display.begin(hardware.profile.display.spiHz);
@@ -0,0 +1,63 @@
+#pragma once
+
+// File-backed `IProgressStorage` for running `ProgressStore` on a Linux host. The file is
+// created erased (0xFF) like a fresh EEPROM region; writes go straight to the file and
+// `commit()` flushes it.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "IProgressStorage.h"
+
+class FileProgressStorage : public IProgressStorage {
+public:
+  FileProgressStorage(const char* pathIn, uint32_t sizeBytes) : path(pathIn), regionSize(sizeBytes) {}
+
+  ~FileProgressStorage() override {
+    if (file != nullptr) {
+      fclose(file);
+    }
+  }
+
+  bool begin() override {
+    file = fopen(path, "r+b");
+    if (file == nullptr) {
+      file = fopen(path, "w+b");
+      if (file == nullptr) {
+        return false;
+      }
+      for (uint32_t i = 0; i < regionSize; i++) {
+        fputc(0xFF, file);
+      }
+      fflush(file);
+    }
+    return true;
+  }
+
+  uint32_t size() const override {
+    return file != nullptr ? regionSize : 0;
+  }
+
+  bool read(uint32_t offset, void* dst, uint32_t len) override {
+    if (file == nullptr || offset + len > regionSize || fseek(file, (long)offset, SEEK_SET) != 0) {
+      return false;
+    }
+    return fread(dst, 1, len, file) == len;
+  }
+
+  bool write(uint32_t offset, const void* src, uint32_t len) override {
+    if (file == nullptr || offset + len > regionSize || fseek(file, (long)offset, SEEK_SET) != 0) {
+      return false;
+    }
+    return fwrite(src, 1, len, file) == len;
+  }
+
+  bool commit() override {
+    return file != nullptr && fflush(file) == 0;
+  }
+
+private:
+  const char* path = nullptr;
+  uint32_t regionSize = 0;
+  FILE* file = nullptr;
+};
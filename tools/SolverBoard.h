@@ -0,0 +1,197 @@
+#pragma once
+
+// Board model shared by the host solvers (tools/par_solver, tools/pack_solver): bitboards over
+// the BOARD_MAX_W x BOARD_MAX_H grid, XSB level parsing with dead-cell analysis, and player
+// reachability with boxes as obstacles.
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "SokobanRules.h"
+
+namespace SolverBoard {
+
+constexpr int W = SokobanRules::BOARD_MAX_W;
+constexpr int CELLS = SokobanRules::BOARD_MAX_CELLS;
+constexpr int PLAYER_SHIFT = 48;
+constexpr int STEP[SokobanRules::DIR_COUNT] = {-1, 1, -W, W};
+constexpr char DIR_CHARS[SokobanRules::DIR_COUNT] = {'l', 'r', 'u', 'd'};
+
+static_assert(CELLS <= 128 + PLAYER_SHIFT, "boxes and player must share three words");
+
+struct Bits {
+  uint64_t w[3] = {0, 0, 0};
+
+  bool test(int i) const {
+    return (w[i >> 6] >> (i & 63)) & 1u;
+  }
+  void set(int i) {
+    w[i >> 6] |= uint64_t(1) << (i & 63);
+  }
+  void clear(int i) {
+    w[i >> 6] &= ~(uint64_t(1) << (i & 63));
+  }
+  bool operator==(const Bits& o) const {
+    return w[0] == o.w[0] && w[1] == o.w[1] && w[2] == o.w[2];
+  }
+};
+
+// Boxes in bits 0..CELLS-1, player cell in the top bits of the last word.
+struct State {
+  Bits bits;
+
+  static State make(const Bits& boxes, int player) {
+    State s;
+    s.bits = boxes;
+    s.bits.w[2] |= uint64_t(player) << PLAYER_SHIFT;
+    return s;
+  }
+  int player() const {
+    return (int)(bits.w[2] >> PLAYER_SHIFT);
+  }
+  Bits boxes() const {
+    Bits b = bits;
+    b.w[2] &= (uint64_t(1) << PLAYER_SHIFT) - 1;
+    return b;
+  }
+};
+
+inline uint64_t stateHash(const State& s) {
+  uint64_t h = s.bits.w[0] * 0x9E3779B97F4A7C15ull;
+  h ^= (s.bits.w[1] + (h >> 29)) * 0xBF58476D1CE4E5B9ull;
+  h ^= (s.bits.w[2] + (h >> 31)) * 0x94D049BB133111EBull;
+  return h ^ (h >> 32);
+}
+
+struct Level {
+  std::vector<std::string> rows;
+  Bits walls;
+  Bits goals;
+  Bits live;
+  Bits startBoxes;
+  int player = -1;
+};
+
+inline bool isBoardRow(const std::string& line) {
+  if (line.find('#') == std::string::npos) {
+    return false;
+  }
+  return line.find_first_not_of("#@+$*. -_") == std::string::npos;
+}
+
+// Fills the bitboards from `level.rows`. Returns false for boards that do not fit, have no
+// player, or whose room reaches the board edge.
+inline bool parseLevel(Level& level) {
+  using SokobanRules::DIR_COUNT;
+  if ((int)level.rows.size() > SokobanRules::BOARD_MAX_H) {
+    return false;
+  }
+  for (int i = 0; i < CELLS; i++) {
+    level.walls.set(i);
+  }
+  for (size_t y = 0; y < level.rows.size(); y++) {
+    const std::string& row = level.rows[y];
+    if ((int)row.size() > W) {
+      return false;
+    }
+    for (size_t x = 0; x < row.size(); x++) {
+      int i = (int)(y * W + x);
+      char c = row[x];
+      if (c == '#') {
+        continue;
+      }
+      level.walls.clear(i);
+      if (SokobanRules::isTarget(c)) {
+        level.goals.set(i);
+      }
+      if (SokobanRules::isBox(c)) {
+        level.startBoxes.set(i);
+      }
+      if (c == '@' || c == '+') {
+        level.player = i;
+      }
+    }
+  }
+  // Spaces outside the room are not floor: only what the player can reach counts. A room
+  // that reaches the board edge is open and rejected, so neighbour steps never wrap.
+  if (level.player < 0) {
+    return false;
+  }
+  Bits inside;
+  std::vector<int> stack = {level.player};
+  inside.set(level.player);
+  while (!stack.empty()) {
+    int c = stack.back();
+    stack.pop_back();
+    if (c % W == 0 || c % W == W - 1 || c / W == 0 || c / W == SokobanRules::BOARD_MAX_H - 1) {
+      return false;
+    }
+    for (int d = 0; d < DIR_COUNT; d++) {
+      int n = c + STEP[d];
+      if (!level.walls.test(n) && !inside.test(n)) {
+        inside.set(n);
+        stack.push_back(n);
+      }
+    }
+  }
+  for (int i = 0; i < CELLS; i++) {
+    if (!inside.test(i)) {
+      level.walls.set(i);
+    }
+  }
+
+  // Live cells: a box there can still be pulled back from some target.
+  stack.clear();
+  for (int i = 0; i < CELLS; i++) {
+    if (level.goals.test(i)) {
+      level.live.set(i);
+      stack.push_back(i);
+    }
+  }
+  while (!stack.empty()) {
+    int c = stack.back();
+    stack.pop_back();
+    for (int d = 0; d < DIR_COUNT; d++) {
+      int n = c + STEP[d];
+      int p = n + STEP[d];
+      if (p < 0 || p >= CELLS || level.walls.test(n) || level.walls.test(p)) {
+        continue;
+      }
+      if (!level.live.test(n)) {
+        level.live.set(n);
+        stack.push_back(n);
+      }
+    }
+  }
+  return true;
+}
+
+// Player reachability with boxes as obstacles; returns the lowest reachable cell.
+inline int flood(const Level& level, const Bits& boxes, int from, Bits& reach) {
+  reach = Bits();
+  int lowest = from;
+  int stack[CELLS];
+  int top = 0;
+  stack[top++] = from;
+  reach.set(from);
+  while (top > 0) {
+    int c = stack[--top];
+    lowest = (c < lowest) ? c : lowest;
+    for (int d = 0; d < SokobanRules::DIR_COUNT; d++) {
+      int n = c + STEP[d];
+      if (!level.walls.test(n) && !boxes.test(n) && !reach.test(n)) {
+        reach.set(n);
+        stack[top++] = n;
+      }
+    }
+  }
+  return lowest;
+}
+
+inline bool canPushTo(const Level& level, const Bits& boxes, int to) {
+  return !level.walls.test(to) && !boxes.test(to) && level.live.test(to);
+}
+
+}  // namespace SolverBoard
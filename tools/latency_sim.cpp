@@ -0,0 +1,218 @@
+// Host model of the button-to-pixel path behind SOKOBAN_LATENCY_PROBE: input edges arrive at
+// random times, are sampled on the 10 ms physics tick, and each move dirties the player and
+// box cells plus the HUD strip; the flush then pushes them over a synthetic SPI link. Every
+// few dozen moves a level is solved and the next one repaints the whole screen, once in one
+// flush (the default build) and once spread out by RepaintSchedule (SOKOBAN_BUDGETED_FLUSH).
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. -o latency_sim tools/latency_sim.cpp LatencyProbe.cpp
+//     RepaintSchedule.cpp
+// Usage:
+//   ./latency_sim [edges] [seed]
+//
+// The SPI cost of a push is a fixed window-setup overhead plus 16 bits per pixel at the
+// profile's clock; rendering costs a fixed time per pixel. The clocks and per-pixel costs
+// below are assumptions to be replaced with figures from LatencyProbe logs on hardware.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "LatencyProbe.h"
+#include "RepaintSchedule.h"
+
+namespace {
+
+constexpr uint32_t STEP_US = 10000u;
+constexpr uint32_t FLUSH_BUDGET_US = 4000u;
+constexpr uint32_t LEVEL_SOLVED_DELAY_US = 750000u;
+constexpr int HUD_H = 44;
+constexpr int FLUSH_TILE = 64;
+constexpr int MOVES_PER_LEVEL = 40;
+constexpr int PUSH_PERCENT = 30;
+constexpr int BOARD_W = 12;
+constexpr int BOARD_H = 9;
+
+struct Profile {
+  const char* name;
+  int screenW;
+  int screenH;
+  double spiMHz;
+  double renderNsPerPixel;
+  double windowOverheadUs;
+};
+
+constexpr Profile PROFILES[] = {
+  {"esp32-st7789-240x240", 240, 240, 40.0, 45.0, 6.0},
+  {"unoq-ili9341-320x240", 320, 240, 24.0, 70.0, 10.0},
+};
+
+class Random {
+public:
+  explicit Random(uint32_t seed) : state(seed != 0 ? seed : 1u) {}
+
+  double uniform() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) / 16777216.0;
+  }
+
+private:
+  uint32_t state;
+};
+
+// Microsecond stamps wrap like `micros()`.
+uint32_t stampUs(double us) {
+  return (uint32_t)std::fmod(us, 4294967296.0);
+}
+
+// Cost of flushing one rect: TileFlusher renders and pushes it in tiles of at most 64x64.
+double flushCostUs(const Profile& p, int w, int h) {
+  if (w <= 0 || h <= 0) {
+    return 0.0;
+  }
+  const int tiles = ((w + FLUSH_TILE - 1) / FLUSH_TILE) * ((h + FLUSH_TILE - 1) / FLUSH_TILE);
+  const double pixels = (double)w * h;
+  return tiles * p.windowOverheadUs + pixels * 16.0 / p.spiMHz +
+         pixels * p.renderNsPerPixel / 1000.0;
+}
+
+RepaintSchedule::Layout layoutFor(const Profile& p, int centerX, int centerY) {
+  int tile = (p.screenW - 8) / BOARD_W;
+  tile = ((p.screenH - HUD_H - 8) / BOARD_H < tile) ? (p.screenH - HUD_H - 8) / BOARD_H : tile;
+  tile = (tile > 20) ? 20 : ((tile < 16) ? 16 : tile);
+  RepaintSchedule::Layout layout{};
+  layout.screenW = p.screenW;
+  layout.screenH = p.screenH;
+  layout.hudH = HUD_H;
+  layout.boardW = BOARD_W;
+  layout.boardH = BOARD_H;
+  layout.tileSize = tile;
+  layout.boardX0 = (p.screenW - BOARD_W * tile) / 2;
+  layout.boardY0 = HUD_H + 4 + (p.screenH - HUD_H - 8 - BOARD_H * tile) / 2;
+  layout.centerX = centerX;
+  layout.centerY = centerY;
+  return layout;
+}
+
+struct Result {
+  LatencyProbe probe;
+  double worstFrameUs = 0.0;
+};
+
+Result simulate(const Profile& p, bool budgeted, int edges, uint32_t seed) {
+  Random rng(seed);
+  Result result;
+  RepaintSchedule schedule;
+  const RepaintSchedule::Layout base = layoutFor(p, 0, 0);
+  const double cellUs = flushCostUs(p, base.tileSize, base.tileSize);
+  const double hudUs = flushCostUs(p, p.screenW, HUD_H);
+
+  double t = 0.0;
+  double nextTick = 0.0;
+  double nextEdge = 0.0;
+  double levelLoadAt = -1.0;
+  int edgesLeft = edges;
+  int moves = 0;
+  bool fullRepaint = false;
+  while (edgesLeft > 0) {
+    // Physics: a tick samples at most one pending edge, as `justPressed()` does.
+    uint32_t edgeUs = 0;
+    double moveUs = 0.0;
+    if (t >= nextTick) {
+      nextTick = (nextTick + STEP_US > t) ? nextTick + STEP_US : t + STEP_US;
+      if (levelLoadAt >= 0.0 && t >= levelLoadAt) {
+        levelLoadAt = -1.0;
+        if (budgeted) {
+          schedule.begin(layoutFor(p, (int)(rng.uniform() * BOARD_W),
+                                   (int)(rng.uniform() * BOARD_H)));
+        } else {
+          fullRepaint = true;
+        }
+      } else if (nextEdge <= t) {
+        // Human key presses: at least 60 ms apart, about 180 ms on average. Presses while
+        // the solved overlay is up do not move anything and are not measured.
+        const bool moved = levelLoadAt < 0.0;
+        edgeUs = moved ? (stampUs(nextEdge) | 1u) : 0u;
+        nextEdge = t + 60000.0 - 120000.0 * std::log(1.0 - rng.uniform());
+      }
+      if (edgeUs != 0) {
+        edgesLeft--;
+        bool push = rng.uniform() * 100.0 < PUSH_PERCENT;
+        moveUs = (push ? 4 : 2) * cellUs + hudUs;
+        if (++moves % MOVES_PER_LEVEL == 0) {
+          levelLoadAt = t + LEVEL_SOLVED_DELAY_US;
+        }
+      }
+    }
+
+    // Process: flush what the step dirtied.
+    double frameUs = 0.0;
+    bool recorded = false;
+    if (fullRepaint) {
+      frameUs = flushCostUs(p, p.screenW, p.screenH);
+      fullRepaint = false;
+    } else if (schedule.active()) {
+      int x = 0;
+      int y = 0;
+      int w = 0;
+      int h = 0;
+      // As in flushRepaintSlice(): the move's rects ride with the first chunk, and chunks
+      // continue until the budget is spent.
+      frameUs = moveUs;
+      while (schedule.next(x, y, w, h)) {
+        frameUs += flushCostUs(p, w, h);
+        if (edgeUs != 0 && !recorded) {
+          result.probe.record(edgeUs, stampUs(t + frameUs));
+          recorded = true;
+        }
+        if (frameUs >= FLUSH_BUDGET_US) {
+          break;
+        }
+      }
+    } else {
+      frameUs = moveUs;
+    }
+    if (edgeUs != 0 && !recorded) {
+      result.probe.record(edgeUs, stampUs(t + frameUs));
+    }
+    result.worstFrameUs = (frameUs > result.worstFrameUs) ? frameUs : result.worstFrameUs;
+    t += frameUs;
+    if (t < nextTick && !schedule.active() && !fullRepaint) {
+      t = nextTick;
+    }
+  }
+  return result;
+}
+
+void report(const Profile& p, const char* mode, const Result& r) {
+  const LatencyProbe& probe = r.probe;
+  printf("%-22s %-9s n %u  min %5.1f  mean %5.1f  max %5.1f ms  worst frame %5.1f ms\n", p.name,
+         mode, (unsigned)probe.samples(), probe.minUs() / 1000.0, probe.meanUs() / 1000.0,
+         probe.maxUs() / 1000.0, r.worstFrameUs / 1000.0);
+  printf("%-22s %-9s", "", "");
+  for (int i = 0; i < LatencyProbe::BUCKETS; i++) {
+    uint32_t limit = LatencyProbe::bucketLimitUs(i);
+    if (limit != 0) {
+      printf(" <%ums %u", (unsigned)(limit / 1000u), (unsigned)probe.bucketCount(i));
+    } else {
+      printf(" >=%ums %u", (unsigned)(LatencyProbe::bucketLimitUs(i - 1) / 1000u),
+             (unsigned)probe.bucketCount(i));
+    }
+  }
+  printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int edges = (argc > 1) ? atoi(argv[1]) : 20000;
+  const uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], nullptr, 0) : 1u;
+  for (const Profile& p : PROFILES) {
+    report(p, "full", simulate(p, false, edges, seed));
+    report(p, "budgeted", simulate(p, true, edges, seed));
+  }
+  return 0;
+}
@@ -0,0 +1,256 @@
+// Encode an XSB level collection into a LevelPack image, and check that every level decodes
+// back to its source. A "; par moves <m> pushes <p>" line (see tools/par_solver) above a
+// level is stored as its par.
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. -o level_pack tools/level_pack.cpp LevelPack.cpp
+// Usage:
+//   ./level_pack <levels.xsb> <out.h | out.bin>
+//
+// Levels are runs of board rows; any other line (";" comments, titles, blank lines) ends a
+// level. "-" and "_" are read as floor. An output ending in ".h" is written as the
+// SokobanLevels::PACK header the game builds from, e.g.
+//   ./level_pack tools/builtin_levels.xsb SokobanLevelPack.h
+// and anything else as the raw image.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Crc32.h"
+#include "LevelPack.h"
+#include "SokobanRules.h"
+
+namespace {
+
+struct Level {
+  std::vector<std::string> rows;
+  unsigned parMoves = 0;
+  unsigned parPushes = 0;
+};
+
+bool isBoardRow(const std::string& line) {
+  if (line.find('#') == std::string::npos) {
+    return false;
+  }
+  return line.find_first_not_of("#@+$*. -_") == std::string::npos;
+}
+
+bool readLevels(const char* path, std::vector<Level>& levels) {
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) {
+    return false;
+  }
+  Level current;
+  char buf[256];
+  while (fgets(buf, sizeof(buf), f) != nullptr) {
+    std::string line(buf);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (isBoardRow(line)) {
+      for (char& c : line) {
+        c = (c == '-' || c == '_') ? ' ' : c;
+      }
+      current.rows.push_back(line);
+      continue;
+    }
+    if (!current.rows.empty()) {
+      levels.push_back(current);
+      current = Level();
+    }
+    sscanf(line.c_str(), "; par moves %u pushes %u", &current.parMoves, &current.parPushes);
+  }
+  if (!current.rows.empty()) {
+    levels.push_back(current);
+  }
+  fclose(f);
+  return true;
+}
+
+char cellAt(const Level& level, size_t x, size_t y) {
+  return x < level.rows[y].size() ? level.rows[y][x] : ' ';
+}
+
+class BitWriter {
+public:
+  explicit BitWriter(std::vector<uint8_t>& outRef) : out(outRef) {}
+
+  void write(uint32_t value, int bits) {
+    for (int i = 0; i < bits; i++) {
+      if (count == 0) {
+        out.push_back(0);
+      }
+      out.back() |= (uint8_t)(((value >> i) & 1u) << count);
+      count = (count + 1) & 7;
+    }
+  }
+
+private:
+  std::vector<uint8_t>& out;
+  int count = 0;
+};
+
+uint8_t symbolOf(char cell) {
+  for (uint8_t s = 0; s < LevelPack::RUN_SYMBOL; s++) {
+    if (LevelPack::SYMBOL_CELLS[s] == cell) {
+      return s;
+    }
+  }
+  return 0;
+}
+
+bool encodeLevel(const Level& level, std::vector<uint8_t>& out) {
+  size_t w = 0;
+  for (const std::string& row : level.rows) {
+    w = row.size() > w ? row.size() : w;
+  }
+  size_t h = level.rows.size();
+  if (w > (size_t)SokobanRules::BOARD_MAX_W || h > (size_t)SokobanRules::BOARD_MAX_H) {
+    return false;
+  }
+  out.push_back((uint8_t)w);
+  out.push_back((uint8_t)h);
+  for (unsigned value : {level.parMoves, level.parPushes}) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+  }
+
+  std::vector<char> cells;
+  for (size_t y = 0; y < h; y++) {
+    for (size_t x = 0; x < w; x++) {
+      cells.push_back(cellAt(level, x, y));
+    }
+  }
+  BitWriter bits(out);
+  for (size_t i = 0; i < cells.size();) {
+    char c = cells[i];
+    size_t run = 1;
+    while (i + run < cells.size() && cells[i + run] == c && run < (size_t)LevelPack::RUN_MAX) {
+      run++;
+    }
+    if ((c == ' ' || c == '#') && run >= (size_t)LevelPack::RUN_MIN) {
+      bits.write(LevelPack::RUN_SYMBOL, LevelPack::SYMBOL_BITS);
+      bits.write(c == '#' ? 1u : 0u, 1);
+      bits.write((uint32_t)(run - LevelPack::RUN_MIN), LevelPack::RUN_LENGTH_BITS);
+      i += run;
+    } else {
+      bits.write(symbolOf(c), LevelPack::SYMBOL_BITS);
+      i++;
+    }
+  }
+  return true;
+}
+
+void putU16(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+  out[at] = (uint8_t)v;
+  out[at + 1] = (uint8_t)(v >> 8);
+}
+
+bool writeHeaderFile(const char* path, const char* source, const std::vector<uint8_t>& pack) {
+  FILE* f = fopen(path, "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "#pragma once\n\n#include <stdint.h>\n\n");
+  fprintf(f, "// Generated by tools/level_pack from %s; do not edit by hand.\n", source);
+  fprintf(f, "namespace SokobanLevels {\n\ninline constexpr uint8_t PACK[] = {\n");
+  for (size_t i = 0; i < pack.size(); i++) {
+    fprintf(f, "%s0x%02x,%s", (i % 12 == 0) ? "  " : "", pack[i],
+            (i % 12 == 11 || i + 1 == pack.size()) ? "\n" : " ");
+  }
+  fprintf(f, "};\n\n}  // namespace SokobanLevels\n");
+  return fclose(f) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <levels.xsb> <out.h | out.bin>\n", argv[0]);
+    return 2;
+  }
+  std::vector<Level> levels;
+  if (!readLevels(argv[1], levels)) {
+    fprintf(stderr, "cannot read %s\n", argv[1]);
+    return 1;
+  }
+  if (levels.empty() || levels.size() > 255) {
+    fprintf(stderr, "%zu levels; a pack holds 1..255\n", levels.size());
+    return 1;
+  }
+
+  std::vector<uint8_t> pack(LevelPack::HEADER_BYTES + 2 * levels.size(), 0);
+  memcpy(pack.data(), "SKP2", 4);
+  pack[LevelPack::COUNT_OFFSET] = (uint8_t)levels.size();
+  size_t sourceBytes = 0;
+  for (size_t i = 0; i < levels.size(); i++) {
+    putU16(pack, LevelPack::HEADER_BYTES + 2 * i, (uint32_t)pack.size());
+    if (!encodeLevel(levels[i], pack)) {
+      fprintf(stderr, "level %zu exceeds %dx%d\n",
+              i + 1, SokobanRules::BOARD_MAX_W, SokobanRules::BOARD_MAX_H);
+      return 1;
+    }
+    for (const std::string& row : levels[i].rows) {
+      sourceBytes += row.size() + 1 + sizeof(const char*);
+    }
+  }
+  size_t payload = pack.size() - LevelPack::HEADER_BYTES;
+  if (payload > 0xFFFF) {
+    fprintf(stderr, "pack payload of %zu bytes exceeds 64 KB\n", payload);
+    return 1;
+  }
+  putU16(pack, 6, (uint32_t)payload);
+  uint32_t crc = crc32(pack.data() + LevelPack::HEADER_BYTES, payload);
+  for (int b = 0; b < 4; b++) {
+    pack[8 + b] = (uint8_t)(crc >> (8 * b));
+  }
+
+  if (!LevelPack::verify(pack.data(), pack.size())) {
+    fprintf(stderr, "encoded pack fails verification\n");
+    return 1;
+  }
+  for (size_t i = 0; i < levels.size(); i++) {
+    SokobanRules::Board board;
+    int w = 0;
+    int h = 0;
+    if (!LevelPack::decode(pack.data(), pack.size(), (int)i, board, w, h)) {
+      fprintf(stderr, "level %zu does not decode\n", i + 1);
+      return 1;
+    }
+    uint16_t moves = 0;
+    uint16_t pushes = 0;
+    LevelPack::par(pack.data(), pack.size(), (int)i, moves, pushes);
+    if (moves != levels[i].parMoves || pushes != levels[i].parPushes) {
+      fprintf(stderr, "level %zu par does not round-trip\n", i + 1);
+      return 1;
+    }
+    for (int y = 0; y < h; y++) {
+      for (int x = 0; x < w; x++) {
+        if (board[y][x] != cellAt(levels[i], (size_t)x, (size_t)y)) {
+          fprintf(stderr, "level %zu differs at (%d, %d)\n", i + 1, x, y);
+          return 1;
+        }
+      }
+    }
+  }
+
+  size_t len = strlen(argv[2]);
+  bool header = len > 2 && strcmp(argv[2] + len - 2, ".h") == 0;
+  bool written = false;
+  if (header) {
+    written = writeHeaderFile(argv[2], argv[1], pack);
+  } else {
+    FILE* f = fopen(argv[2], "wb");
+    written = f != nullptr && fwrite(pack.data(), 1, pack.size(), f) == pack.size();
+    written = (f != nullptr && fclose(f) == 0) && written;
+  }
+  if (!written) {
+    fprintf(stderr, "cannot write %s\n", argv[2]);
+    return 1;
+  }
+  fprintf(stderr, "%zu levels, %zu bytes packed (rows as C strings: %zu bytes)\n",
+          levels.size(), pack.size(), sourceBytes);
+  return 0;
+}
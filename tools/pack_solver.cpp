@@ -0,0 +1,961 @@
+// Solve every level of a pack push-optimally on all host cores, for curating packs and
+// checking pars before they are embedded. Each level gets a LURD solution and search stats.
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -pthread -I. -Itools -o pack_solver tools/pack_solver.cpp
+//     LevelPack.cpp SokobanLevels.cpp
+// Usage:
+//   ./pack_solver [--threads N] [--mem MB] [--ida] [--sweep] (<levels.xsb> | --builtin)
+//
+// The search is a layered breadth-first search over push states (box bitboard plus the
+// lowest cell the player can reach), so the first solution found has the fewest pushes;
+// moves are not minimised, tools/par_solver does that. Every visited state is appended once
+// to a record array holding its parent link, and a lock-free open-addressing index over
+// those records is the transposition table all threads share: a new state is published with
+// a single compare-and-swap of an empty slot. Since records are appended in search order,
+// the next layer is exactly the records added while expanding the current one. Layers are
+// split into chunks that each thread takes from its own range, stealing half of another
+// thread's range once its own runs dry.
+//
+// The records and index together stay under --mem (default 1024 MB). When a level needs
+// more, the search restarts as a parallel IDA* with the sum of per-box push distances as the
+// heuristic, which holds only the current path per thread; --ida forces that for every
+// level. Stats go to stdout with each solution, a summary with the process peak RSS to
+// stderr. --sweep solves the pack at 1, 2, 4, 8 and 16 threads and prints the throughput of
+// each against one thread.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SokobanLevels.h"
+#include "SokobanRules.h"
+#include "SolverBoard.h"
+
+namespace {
+
+using namespace SokobanRules;
+using namespace SolverBoard;
+
+constexpr uint32_t NO_RECORD = 0xFFFFFFFFu;
+// Records per work item; smaller layers are expanded by the calling thread alone.
+constexpr uint32_t CHUNK = 256;
+constexpr size_t INITIAL_INDEX_SLOTS = size_t(1) << 16;
+constexpr int INF = 1 << 20;
+
+struct Push {
+  uint8_t box;  // cell of the box before the push
+  uint8_t dir;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs one job on every worker, the calling thread being worker 0, and returns when all of
+// them have finished. Threads persist across jobs, so a layer costs two wake-ups, not spawns.
+class WorkerPool {
+public:
+  explicit WorkerPool(int workers) : count(workers) {
+    for (int i = 1; i < workers; i++) {
+      threads.emplace_back([this, i] { loop(i); });
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) {
+      t.join();
+    }
+  }
+
+  int size() const {
+    return count;
+  }
+
+  void run(const std::function<void(int)>& fn) {
+    if (count == 1) {
+      fn(0);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = &fn;
+      pending = count - 1;
+      generation++;
+    }
+    wake.notify_all();
+    fn(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    job = nullptr;
+  }
+
+private:
+  int count;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const std::function<void(int)>* job = nullptr;
+  uint64_t generation = 0;
+  int pending = 0;
+  bool stopping = false;
+
+  void loop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+      const std::function<void(int)>* fn = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) {
+          return;
+        }
+        seen = generation;
+        fn = job;
+      }
+      (*fn)(worker);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    }
+  }
+};
+
+// Work items 0..total-1 dealt out as one contiguous range per worker. A range is a single
+// 64-bit word (next in the low half, end in the high half): the owner takes items from the
+// front with a CAS, a thief moves the back half of a victim's range into its own with one.
+// No item is created during a pass, so a scan that finds every range empty means done.
+class StealingRanges {
+public:
+  explicit StealingRanges(int workers) : count(workers), ranges(new Range[workers]) {}
+
+  void reset(uint32_t total) {
+    for (int w = 0; w < count; w++) {
+      const uint32_t begin = (uint32_t)((uint64_t)total * w / count);
+      const uint32_t end = (uint32_t)((uint64_t)total * (w + 1) / count);
+      ranges[w].span.store(pack(begin, end), std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  bool next(int worker, uint32_t& item) {
+    while (!take(worker, item)) {
+      if (!steal(worker)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint64_t steals() const {
+    return stolen.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct alignas(64) Range {
+    std::atomic<uint64_t> span{0};
+  };
+
+  int count;
+  std::unique_ptr<Range[]> ranges;
+  std::atomic<uint64_t> stolen{0};
+
+  static uint64_t pack(uint32_t begin, uint32_t end) {
+    return (uint64_t)end << 32 | begin;
+  }
+
+  bool take(int worker, uint32_t& item) {
+    std::atomic<uint64_t>& span = ranges[worker].span;
+    uint64_t cur = span.load(std::memory_order_acquire);
+    for (;;) {
+      const uint32_t begin = (uint32_t)cur;
+      const uint32_t end = (uint32_t)(cur >> 32);
+      if (begin >= end) {
+        return false;
+      }
+      if (span.compare_exchange_weak(cur, pack(begin + 1, end), std::memory_order_acq_rel)) {
+        item = begin;
+        return true;
+      }
+    }
+  }
+
+  bool steal(int thief) {
+    for (int k = 1; k < count; k++) {
+      std::atomic<uint64_t>& span = ranges[(thief + k) % count].span;
+      uint64_t cur = span.load(std::memory_order_acquire);
+      for (;;) {
+        const uint32_t begin = (uint32_t)cur;
+        const uint32_t end = (uint32_t)(cur >> 32);
+        if (begin >= end) {
+          break;
+        }
+        const uint32_t mid = begin + (end - begin) / 2;
+        if (span.compare_exchange_weak(cur, pack(begin, mid), std::memory_order_acq_rel)) {
+          ranges[thief].span.store(pack(mid, end), std::memory_order_release);
+          stolen.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
+// One visited push state. Plain words, so the array can be left unwritten until used.
+struct Record {
+  uint64_t w[3];
+  uint32_t parent;
+  uint8_t box;
+  uint8_t dir;
+  uint8_t dead;  // lost an insertion race; the state lives in another record
+
+  State state() const {
+    State s;
+    s.bits.w[0] = w[0];
+    s.bits.w[1] = w[1];
+    s.bits.w[2] = w[2];
+    return s;
+  }
+};
+
+// Append-only records plus the index over them. The index slot is the upper half of the
+// state hash and the record number + 1 in one word, 0 when empty; it is kept at most half
+// full and can only grow between passes, when no thread is inserting.
+class TranspositionTable {
+public:
+  enum class Insert { Added, Present, Full };
+
+  explicit TranspositionTable(size_t memBytes) : budget(memBytes) {
+    // A record plus up to four index slots per state, as the index doubles once half full.
+    capacity = (uint32_t)std::min<size_t>(memBytes / (sizeof(Record) + 4 * sizeof(uint64_t)),
+                                          NO_RECORD - 1);
+    records = static_cast<Record*>(std::malloc((size_t)capacity * sizeof(Record)));
+    resize(INITIAL_INDEX_SLOTS);
+  }
+
+  ~TranspositionTable() {
+    std::free(records);
+  }
+
+  Insert insert(const State& s, uint32_t parent, int box, int dir) {
+    const uint64_t h = stateHash(s);
+    const uint64_t tag = h & 0xFFFFFFFF00000000ull;
+    uint32_t mine = NO_RECORD;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      uint64_t v = index[i].load(std::memory_order_acquire);
+      if (v == 0) {
+        if (mine == NO_RECORD) {
+          if (used.load(std::memory_order_relaxed) >= (mask + 1) / 2) {
+            return Insert::Full;
+          }
+          mine = appended.fetch_add(1, std::memory_order_relaxed);
+          if (mine >= capacity) {
+            appended.fetch_sub(1, std::memory_order_relaxed);
+            return Insert::Full;
+          }
+          Record& r = records[mine];
+          memcpy(r.w, s.bits.w, sizeof(r.w));
+          r.parent = parent;
+          r.box = (uint8_t)box;
+          r.dir = (uint8_t)dir;
+          r.dead = 0;
+        }
+        if (index[i].compare_exchange_strong(v, tag | (mine + 1), std::memory_order_acq_rel)) {
+          used.fetch_add(1, std::memory_order_relaxed);
+          return Insert::Added;
+        }
+        // Another thread took the slot; `v` is now its entry.
+      }
+      if ((v & 0xFFFFFFFF00000000ull) == tag &&
+          memcmp(records[(uint32_t)v - 1].w, s.bits.w, sizeof(s.bits.w)) == 0) {
+        if (mine != NO_RECORD) {
+          records[mine].dead = 1;
+        }
+        return Insert::Present;
+      }
+    }
+  }
+
+  // Doubles the index if the memory budget allows, rehashing every record on all workers.
+  bool grow(WorkerPool& pool, StealingRanges& ranges) {
+    const size_t slots = (mask + 1) * 2;
+    if (appended.load() >= capacity || slots * sizeof(uint64_t) > budget / 2) {
+      return false;
+    }
+    resize(slots);
+    const uint32_t total = appended.load();
+    ranges.reset((total + CHUNK - 1) / CHUNK);
+    pool.run([&](int worker) {
+      uint32_t chunk = 0;
+      while (ranges.next(worker, chunk)) {
+        const uint32_t end = std::min(total, (chunk + 1) * CHUNK);
+        for (uint32_t r = chunk * CHUNK; r < end; r++) {
+          if (!records[r].dead) {
+            place(r);
+          }
+        }
+      }
+    });
+    used.store(total);
+    return true;
+  }
+
+  const Record& record(uint32_t r) const {
+    return records[r];
+  }
+
+  uint32_t size() const {
+    return appended.load(std::memory_order_acquire);
+  }
+
+  // Bytes actually touched: written records and the current index.
+  size_t bytes() const {
+    return (size_t)size() * sizeof(Record) + (mask + 1) * sizeof(uint64_t);
+  }
+
+private:
+  size_t budget;
+  uint32_t capacity = 0;
+  Record* records = nullptr;
+  std::atomic<uint32_t> appended{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> index;
+  size_t mask = 0;
+  std::atomic<size_t> used{0};
+
+  void resize(size_t slots) {
+    index.reset(new std::atomic<uint64_t>[slots]());
+    mask = slots - 1;
+  }
+
+  // Rehash of a known-unique record.
+  void place(uint32_t r) {
+    const uint64_t h = stateHash(records[r].state());
+    const uint64_t entry = (h & 0xFFFFFFFF00000000ull) | (r + 1);
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      uint64_t expected = 0;
+      if (index[i].compare_exchange_strong(expected, entry, std::memory_order_acq_rel)) {
+        return;
+      }
+    }
+  }
+};
+
+// A 2x2 block of walls and boxes can never be broken up; it is lost unless every box in it
+// already stands on a target. Only blocks containing the box just pushed can be new.
+bool frozenSquare(const Level& level, const Bits& boxes, int to) {
+  static constexpr int CORNERS[4] = {0, -1, -W, -W - 1};
+  for (int corner : CORNERS) {
+    const int tl = to + corner;
+    const int cells[4] = {tl, tl + 1, tl + W, tl + W + 1};
+    bool blocked = true;
+    bool offTarget = false;
+    for (int c : cells) {
+      const bool box = boxes.test(c);
+      if (!box && !level.walls.test(c)) {
+        blocked = false;
+        break;
+      }
+      offTarget = offTarget || (box && !level.goals.test(c));
+    }
+    if (blocked && offTarget) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Calls `fn(box, dir, to, movedBoxes)` for every push the player can make from `reachFrom`,
+// skipping pushes onto dead cells and into frozen squares, until `fn` returns false.
+template <class Fn>
+void forEachPush(const Level& level, const Bits& boxes, int reachFrom, Fn&& fn) {
+  Bits reach;
+  flood(level, boxes, reachFrom, reach);
+  for (int word = 0; word < 3; word++) {
+    uint64_t bits = boxes.w[word];
+    while (bits != 0) {
+      const int b = word * 64 + __builtin_ctzll(bits);
+      bits &= bits - 1;
+      for (int d = 0; d < DIR_COUNT; d++) {
+        const int to = b + STEP[d];
+        if (!reach.test(b - STEP[d]) || !canPushTo(level, boxes, to)) {
+          continue;
+        }
+        Bits moved = boxes;
+        moved.clear(b);
+        moved.set(to);
+        if (!frozenSquare(level, moved, to) && !fn(b, d, to, moved)) {
+          return;
+        }
+      }
+    }
+  }
+}
+
+// Pushes needed to bring a box from each cell to the nearest target with no other boxes on
+// the board, found by pulling back from the targets; INF on dead cells.
+std::vector<int> pushDistances(const Level& level) {
+  std::vector<int> dist(CELLS, INF);
+  std::vector<int> queue;
+  for (int i = 0; i < CELLS; i++) {
+    if (level.goals.test(i)) {
+      dist[i] = 0;
+      queue.push_back(i);
+    }
+  }
+  for (size_t head = 0; head < queue.size(); head++) {
+    const int c = queue[head];
+    for (int d = 0; d < DIR_COUNT; d++) {
+      const int n = c + STEP[d];
+      const int p = n + STEP[d];
+      if (p < 0 || p >= CELLS || level.walls.test(n) || level.walls.test(p) || dist[n] != INF) {
+        continue;
+      }
+      dist[n] = dist[c] + 1;
+      queue.push_back(n);
+    }
+  }
+  return dist;
+}
+
+struct LevelStats {
+  const char* method = "none";
+  bool solved = false;
+  std::vector<Push> pushes;
+  std::string lurd;
+  uint64_t nodes = 0;
+  double seconds = 0;
+  size_t peakBytes = 0;
+};
+
+class PackSolver {
+public:
+  PackSolver(int threads, size_t memBytes, bool idaOnly)
+    : pool(threads), ranges(threads), memBytes(memBytes), idaOnly(idaOnly),
+      nodeCounts(new Counter[threads]) {}
+
+  LevelStats solve(const Level& level) {
+    LevelStats stats;
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t stealsBefore = ranges.steals();
+    if (level.startBoxes == level.goals) {
+      stats.method = "start";
+      stats.solved = true;
+    } else if (idaOnly || !breadthFirst(level, stats)) {
+      idaStar(level, stats);
+    }
+    steals += ranges.steals() - stealsBefore;
+    stats.seconds = secondsSince(start);
+    return stats;
+  }
+
+  int threads() const {
+    return pool.size();
+  }
+
+  uint64_t stealCount() const {
+    return steals;
+  }
+
+private:
+  struct alignas(64) Counter {
+    uint64_t nodes = 0;
+  };
+
+  WorkerPool pool;
+  StealingRanges ranges;
+  size_t memBytes;
+  bool idaOnly;
+  std::unique_ptr<Counter[]> nodeCounts;
+  uint64_t steals = 0;
+  std::atomic<bool> found{false};
+
+  void resetNodes() {
+    for (int w = 0; w < pool.size(); w++) {
+      nodeCounts[w].nodes = 0;
+    }
+  }
+
+  uint64_t totalNodes() const {
+    uint64_t total = 0;
+    for (int w = 0; w < pool.size(); w++) {
+      total += nodeCounts[w].nodes;
+    }
+    return total;
+  }
+
+  // Runs `fn(worker, item)` over items 0..total-1 on the pool, or inline when the pass is too
+  // small to be worth waking the other threads.
+  template <class Fn>
+  void parallelFor(uint32_t total, Fn&& fn) {
+    ranges.reset(total);
+    auto job = [&](int worker) {
+      uint32_t item = 0;
+      while (ranges.next(worker, item)) {
+        fn(worker, item);
+      }
+    };
+    if (total <= 1) {
+      job(0);
+    } else {
+      pool.run(job);
+    }
+  }
+
+  // Returns false when the level outgrew the memory budget; `stats` then holds only the
+  // nodes and memory spent.
+  bool breadthFirst(const Level& level, LevelStats& stats) {
+    TranspositionTable table(memBytes);
+    resetNodes();
+    found = false;
+    std::atomic<uint32_t> goalParent{NO_RECORD};
+    Push goalPush{};
+    Bits reach;
+    table.insert(State::make(level.startBoxes, flood(level, level.startBoxes, level.player, reach)),
+                 NO_RECORD, 0, 0);
+    uint32_t layerBegin = 0;
+    uint32_t layerEnd = 1;
+    bool outOfMemory = false;
+    while (layerBegin < layerEnd && !found && !outOfMemory) {
+      for (;;) {
+        std::atomic<bool> full{false};
+        const uint32_t base = layerBegin;
+        const uint32_t end = layerEnd;
+        parallelFor((end - base + CHUNK - 1) / CHUNK, [&](int worker, uint32_t chunk) {
+          const uint32_t last = std::min(end, base + (chunk + 1) * CHUNK);
+          for (uint32_t r = base + chunk * CHUNK; r < last; r++) {
+            if (found.load(std::memory_order_relaxed) || full.load(std::memory_order_relaxed)) {
+              return;
+            }
+            const Record& rec = table.record(r);
+            if (rec.dead) {
+              continue;
+            }
+            nodeCounts[worker].nodes++;
+            const State s = rec.state();
+            forEachPush(level, s.boxes(), s.player(), [&](int b, int d, int, const Bits& moved) {
+              if (moved == level.goals) {
+                uint32_t none = NO_RECORD;
+                if (goalParent.compare_exchange_strong(none, r)) {
+                  goalPush = Push{(uint8_t)b, (uint8_t)d};
+                  found = true;
+                }
+                return false;
+              }
+              Bits ignored;
+              const State child = State::make(moved, flood(level, moved, b, ignored));
+              if (table.insert(child, r, b, d) == TranspositionTable::Insert::Full) {
+                full = true;
+                return false;
+              }
+              return true;
+            });
+          }
+        });
+        stats.peakBytes = std::max(stats.peakBytes, table.bytes());
+        if (!full || found) {
+          break;
+        }
+        // States this pass already added stay in the table, so the retry skips them and the
+        // next layer still ends up as one contiguous run of records.
+        if (!table.grow(pool, ranges)) {
+          outOfMemory = true;
+          break;
+        }
+        stats.peakBytes = std::max(stats.peakBytes, table.bytes());
+      }
+      layerBegin = layerEnd;
+      layerEnd = table.size();
+    }
+    stats.nodes += totalNodes();
+    if (outOfMemory) {
+      return false;
+    }
+    if (found) {
+      stats.method = "bfs";
+      stats.solved = true;
+      stats.pushes.push_back(goalPush);
+      for (uint32_t r = goalParent; table.record(r).parent != NO_RECORD;) {
+        const Record& rec = table.record(r);
+        stats.pushes.push_back(Push{rec.box, rec.dir});
+        r = rec.parent;
+      }
+      std::reverse(stats.pushes.begin(), stats.pushes.end());
+    }
+    return true;
+  }
+
+  struct IdaRoot {
+    State state;
+    int h;
+    std::vector<Push> path;
+  };
+
+  // Iterative deepening on pushes + heuristic. Each iteration's roots are the states a few
+  // pushes from the start, dealt out through the stealing ranges; a thread keeps only its
+  // current path and skips states already on it.
+  void idaStar(const Level& level, LevelStats& stats) {
+    const std::vector<int> dist = pushDistances(level);
+    auto heuristic = [&](const Bits& boxes) {
+      int h = 0;
+      for (int i = 0; i < CELLS; i++) {
+        h += boxes.test(i) ? dist[i] : 0;
+      }
+      return h;
+    };
+    resetNodes();
+    found = false;
+    std::mutex solutionMutex;
+    std::vector<Push> solution;
+    auto finish = [&](const std::vector<Push>& path) {
+      std::lock_guard<std::mutex> lock(solutionMutex);
+      if (!found) {
+        solution = path;
+        found = true;
+      }
+    };
+
+    // Roots: expand breadth-first until there is enough work to spread over the threads.
+    Bits reach;
+    std::vector<IdaRoot> roots = {
+      IdaRoot{State::make(level.startBoxes, flood(level, level.startBoxes, level.player, reach)),
+              heuristic(level.startBoxes), {}}};
+    const size_t wanted = (size_t)pool.size() * 64;
+    for (int depth = 0; depth < 6 && roots.size() < wanted && !found; depth++) {
+      std::vector<IdaRoot> next;
+      for (const IdaRoot& root : roots) {
+        nodeCounts[0].nodes++;
+        const State& s = root.state;
+        forEachPush(level, s.boxes(), s.player(), [&](int b, int d, int to, const Bits& moved) {
+          std::vector<Push> path = root.path;
+          path.push_back(Push{(uint8_t)b, (uint8_t)d});
+          if (moved == level.goals) {
+            finish(path);
+            return false;
+          }
+          Bits ignored;
+          next.push_back(IdaRoot{State::make(moved, flood(level, moved, b, ignored)),
+                                 root.h - dist[b] + dist[to], std::move(path)});
+          return true;
+        });
+        if (found) {
+          break;
+        }
+      }
+      if (next.empty()) {
+        break;
+      }
+      std::sort(next.begin(), next.end(), [](const IdaRoot& a, const IdaRoot& b) {
+        return memcmp(a.state.bits.w, b.state.bits.w, sizeof(a.state.bits.w)) < 0;
+      });
+      next.erase(std::unique(next.begin(), next.end(),
+                             [](const IdaRoot& a, const IdaRoot& b) {
+                               return a.state.bits == b.state.bits;
+                             }),
+                 next.end());
+      roots.swap(next);
+    }
+    const int rootDepth = roots.empty() ? 0 : (int)roots[0].path.size();
+
+    int bound = heuristic(level.startBoxes);
+    while (!found && !roots.empty()) {
+      std::atomic<int> nextBound{INF};
+      parallelFor((uint32_t)roots.size(), [&](int worker, uint32_t item) {
+        const IdaRoot& root = roots[item];
+        std::vector<Push> path = root.path;
+        std::vector<State> onPath = {root.state};
+        int exceeded = INF;
+        uint64_t& nodes = nodeCounts[worker].nodes;
+        std::function<bool(const State&, int)> dfs = [&](const State& s, int h) {
+          if (found.load(std::memory_order_relaxed)) {
+            return false;
+          }
+          const int f = (int)path.size() + h;
+          if (f > bound) {
+            exceeded = std::min(exceeded, f);
+            return false;
+          }
+          nodes++;
+          bool solved = false;
+          forEachPush(level, s.boxes(), s.player(), [&](int b, int d, int to, const Bits& moved) {
+            path.push_back(Push{(uint8_t)b, (uint8_t)d});
+            if (moved == level.goals) {
+              if ((int)path.size() <= bound) {
+                finish(path);
+                solved = true;
+              } else {
+                exceeded = std::min(exceeded, (int)path.size());
+              }
+              path.pop_back();
+              return !solved;
+            }
+            Bits ignored;
+            const State child = State::make(moved, flood(level, moved, b, ignored));
+            bool repeated = false;
+            for (const State& p : onPath) {
+              repeated = repeated || p.bits == child.bits;
+            }
+            if (!repeated) {
+              onPath.push_back(child);
+              solved = dfs(child, h - dist[b] + dist[to]);
+              onPath.pop_back();
+            }
+            path.pop_back();
+            return !solved && !found.load(std::memory_order_relaxed);
+          });
+          return solved;
+        };
+        dfs(root.state, root.h);
+        int cur = nextBound.load();
+        while (exceeded < cur && !nextBound.compare_exchange_weak(cur, exceeded)) {
+        }
+      });
+      if (found || nextBound.load() >= INF) {
+        break;
+      }
+      // Roots sit at a fixed depth, so a bound below it only prunes them all again.
+      bound = std::max(nextBound.load(), rootDepth);
+    }
+    stats.nodes += totalNodes();
+    stats.peakBytes = std::max(stats.peakBytes, roots.size() * sizeof(IdaRoot));
+    if (found) {
+      stats.method = "ida*";
+      stats.solved = true;
+      stats.pushes = solution;
+    }
+  }
+};
+
+// Expands pushes into LURD: lower case for walks, found by breadth-first search around the
+// boxes, upper case for pushes. Returns false if a push cannot be made.
+bool toLurd(const Level& level, const std::vector<Push>& pushes, std::string& lurd) {
+  Bits boxes = level.startBoxes;
+  int player = level.player;
+  for (const Push& push : pushes) {
+    const int target = push.box - STEP[push.dir];
+    std::vector<int> from(CELLS, -1);
+    std::vector<int> queue = {player};
+    from[player] = player;
+    for (size_t head = 0; head < queue.size() && from[target] < 0; head++) {
+      const int c = queue[head];
+      for (int d = 0; d < DIR_COUNT; d++) {
+        const int n = c + STEP[d];
+        if (!level.walls.test(n) && !boxes.test(n) && from[n] < 0) {
+          from[n] = c;
+          queue.push_back(n);
+        }
+      }
+    }
+    if (from[target] < 0 || !boxes.test(push.box) || boxes.test(push.box + STEP[push.dir]) ||
+        level.walls.test(push.box + STEP[push.dir])) {
+      return false;
+    }
+    std::string walk;
+    for (int c = target; c != player; c = from[c]) {
+      for (int d = 0; d < DIR_COUNT; d++) {
+        if (from[c] + STEP[d] == c) {
+          walk.push_back(DIR_CHARS[d]);
+        }
+      }
+    }
+    lurd.append(walk.rbegin(), walk.rend());
+    lurd.push_back((char)(DIR_CHARS[push.dir] - 'a' + 'A'));
+    boxes.clear(push.box);
+    boxes.set(push.box + STEP[push.dir]);
+    player = push.box;
+  }
+  return boxes == level.goals;
+}
+
+bool readXsb(const char* path, std::vector<Level>& levels) {
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) {
+    return false;
+  }
+  Level level;
+  char buf[256];
+  while (fgets(buf, sizeof(buf), f) != nullptr) {
+    std::string line(buf);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (isBoardRow(line)) {
+      for (char& c : line) {
+        c = (c == '-' || c == '_') ? ' ' : c;
+      }
+      level.rows.push_back(line);
+    } else if (!level.rows.empty()) {
+      levels.push_back(level);
+      level = Level();
+    }
+  }
+  if (!level.rows.empty()) {
+    levels.push_back(level);
+  }
+  fclose(f);
+  return true;
+}
+
+void readBuiltin(std::vector<Level>& levels) {
+  for (int i = 0; i < SokobanLevels::LEVEL_COUNT; i++) {
+    Board board;
+    int width = 0;
+    int height = 0;
+    Level level;
+    if (SokobanLevels::load((uint8_t)i, board, width, height)) {
+      for (int y = 0; y < height; y++) {
+        level.rows.emplace_back(board[y], width);
+      }
+    }
+    levels.push_back(level);
+  }
+}
+
+double peakRssMb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;  // kilobytes on Linux
+}
+
+struct PackTotals {
+  int solved = 0;
+  uint64_t nodes = 0;
+  double seconds = 0;
+};
+
+// `valid[i]` is what parseLevel returned for level i.
+PackTotals solvePack(const std::vector<Level>& levels, const std::vector<bool>& valid,
+                     int threads, size_t memBytes, bool idaOnly, bool print) {
+  PackSolver solver(threads, memBytes, idaOnly);
+  PackTotals totals;
+  for (size_t i = 0; i < levels.size(); i++) {
+    const Level& level = levels[i];
+    LevelStats stats;
+    if (valid[i]) {
+      stats = solver.solve(level);
+    }
+    const bool replayed = stats.solved && toLurd(level, stats.pushes, stats.lurd);
+    totals.solved += replayed;
+    totals.nodes += stats.nodes;
+    totals.seconds += stats.seconds;
+    if (!print) {
+      continue;
+    }
+    printf("; level %zu: ", i + 1);
+    if (!valid[i]) {
+      printf("not a valid level\n");
+    } else if (!stats.solved) {
+      printf("no solution (%s)", stats.method);
+    } else if (!replayed) {
+      printf("solution does not replay (%s)", stats.method);
+    } else {
+      printf("pushes %zu moves %zu (%s)", stats.pushes.size(), stats.lurd.size(), stats.method);
+    }
+    if (valid[i]) {
+      printf(", %llu nodes, %.1f ms, %.2f M nodes/s, peak %.1f MB\n",
+             (unsigned long long)stats.nodes, stats.seconds * 1e3,
+             stats.seconds > 0 ? stats.nodes / stats.seconds / 1e6 : 0.0,
+             stats.peakBytes / (1024.0 * 1024.0));
+    }
+    for (const std::string& row : level.rows) {
+      printf("%s\n", row.c_str());
+    }
+    if (replayed) {
+      printf("%s\n", stats.lurd.c_str());
+    }
+    printf("\n");
+  }
+  if (print) {
+    fprintf(stderr, "%d/%zu levels solved on %d threads: %llu nodes in %.2f s (%.2f M nodes/s), "
+            "%llu steals, peak RSS %.1f MB\n",
+            totals.solved, levels.size(), solver.threads(), (unsigned long long)totals.nodes,
+            totals.seconds, totals.seconds > 0 ? totals.nodes / totals.seconds / 1e6 : 0.0,
+            (unsigned long long)solver.stealCount(), peakRssMb());
+  }
+  return totals;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  size_t memMb = 1024;
+  bool idaOnly = false;
+  bool sweep = false;
+  bool builtin = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--mem" && i + 1 < argc) {
+      memMb = (size_t)std::max(1, atoi(argv[++i]));
+    } else if (arg == "--ida") {
+      idaOnly = true;
+    } else if (arg == "--sweep") {
+      sweep = true;
+    } else if (arg == "--builtin") {
+      builtin = true;
+    } else if (path == nullptr && arg[0] != '-') {
+      path = argv[i];
+    } else {
+      path = nullptr;
+      builtin = false;
+      break;
+    }
+  }
+  if (path == nullptr && !builtin) {
+    fprintf(stderr,
+            "usage: %s [--threads N] [--mem MB] [--ida] [--sweep] (<levels.xsb> | --builtin)\n",
+            argv[0]);
+    return 2;
+  }
+  std::vector<Level> levels;
+  if (builtin) {
+    readBuiltin(levels);
+  } else if (!readXsb(path, levels)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+
+  std::vector<bool> valid;
+  for (Level& level : levels) {
+    valid.push_back(!level.rows.empty() && parseLevel(level));
+  }
+
+  const size_t memBytes = memMb * 1024 * 1024;
+  if (!sweep) {
+    const PackTotals totals = solvePack(levels, valid, threads, memBytes, idaOnly, true);
+    return totals.solved == (int)levels.size() ? 0 : 1;
+  }
+  printf("threads  solved  M nodes/s  speedup\n");
+  double base = 0;
+  for (int n = 1; n <= 16; n *= 2) {
+    const PackTotals totals = solvePack(levels, valid, n, memBytes, idaOnly, false);
+    const double rate = totals.seconds > 0 ? totals.nodes / totals.seconds / 1e6 : 0.0;
+    base = (n == 1) ? rate : base;
+    printf("%7d  %6d  %9.2f  %6.2fx\n", n, totals.solved, rate, base > 0 ? rate / base : 0.0);
+  }
+  printf("%u hardware threads\n", std::thread::hardware_concurrency());
+  return 0;
+}
@@ -0,0 +1,239 @@
+// Compute move-optimal and push-optimal solution lengths ("par") for every level of an XSB
+// collection, and write the collection back with a "; par moves <m> pushes <p>" line in
+// front of each level. tools/level_pack embeds those lines in the pack.
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. -Itools -o par_solver tools/par_solver.cpp
+// Usage:
+//   ./par_solver <levels.xsb> [max-states] > annotated.xsb
+//   ./par_solver tools/builtin_levels.xsb > /tmp/b.xsb && mv /tmp/b.xsb tools/builtin_levels.xsb
+//
+// Both searches are layered breadth-first searches, so only the visited set and two layers
+// are held. A state is the box bitboard plus the player cell in three 64-bit words, kept in
+// an open-addressing hash set. The push search stores the player as the lowest cell of its
+// reachable area, so states that differ only by walking collapse into one. Boxes are never
+// pushed onto cells from which no target can be reached. A level whose search exceeds
+// max-states (default 50 million) gets par 0, meaning unknown.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SokobanRules.h"
+#include "SolverBoard.h"
+
+namespace {
+
+using namespace SokobanRules;
+using namespace SolverBoard;
+
+// Open addressing, linear probing; an all-ones key marks an empty slot.
+class StateSet {
+public:
+  explicit StateSet(size_t capacityLog2 = 16) {
+    slots.assign(size_t(1) << capacityLog2, emptyState());
+  }
+
+  // Returns false when `s` was already present.
+  bool insert(const State& s) {
+    if ((count + 1) * 2 > slots.size()) {
+      grow();
+    }
+    if (!place(slots, s)) {
+      return false;
+    }
+    count++;
+    return true;
+  }
+
+  size_t size() const {
+    return count;
+  }
+
+private:
+  std::vector<State> slots;
+  size_t count = 0;
+
+  static State emptyState() {
+    State s;
+    s.bits.w[0] = s.bits.w[1] = s.bits.w[2] = ~uint64_t(0);
+    return s;
+  }
+
+  static bool place(std::vector<State>& table, const State& s) {
+    const size_t mask = table.size() - 1;
+    const State empty = emptyState();
+    for (size_t i = stateHash(s) & mask;; i = (i + 1) & mask) {
+      if (table[i].bits == empty.bits) {
+        table[i] = s;
+        return true;
+      }
+      if (table[i].bits == s.bits) {
+        return false;
+      }
+    }
+  }
+
+  void grow() {
+    std::vector<State> bigger(slots.size() * 2, emptyState());
+    const State empty = emptyState();
+    for (const State& s : slots) {
+      if (!(s.bits == empty.bits)) {
+        place(bigger, s);
+      }
+    }
+    slots.swap(bigger);
+  }
+};
+
+int solveMoves(const Level& level, size_t maxStates) {
+  if (level.startBoxes == level.goals) {
+    return 0;
+  }
+  StateSet seen;
+  std::vector<State> layer = {State::make(level.startBoxes, level.player)};
+  seen.insert(layer[0]);
+  std::vector<State> next;
+  for (int depth = 1; !layer.empty(); depth++) {
+    next.clear();
+    for (const State& s : layer) {
+      const int p = s.player();
+      const Bits boxes = s.boxes();
+      for (int d = 0; d < DIR_COUNT; d++) {
+        int n = p + STEP[d];
+        if (level.walls.test(n)) {
+          continue;
+        }
+        Bits moved = boxes;
+        if (boxes.test(n)) {
+          if (!canPushTo(level, boxes, n + STEP[d])) {
+            continue;
+          }
+          moved.clear(n);
+          moved.set(n + STEP[d]);
+          if (moved == level.goals) {
+            return depth;
+          }
+        }
+        State ns = State::make(moved, n);
+        if (seen.insert(ns)) {
+          next.push_back(ns);
+        }
+      }
+    }
+    if (seen.size() > maxStates) {
+      return -1;
+    }
+    layer.swap(next);
+  }
+  return -1;
+}
+
+int solvePushes(const Level& level, size_t maxStates) {
+  if (level.startBoxes == level.goals) {
+    return 0;
+  }
+  Bits reach;
+  StateSet seen;
+  int start = flood(level, level.startBoxes, level.player, reach);
+  std::vector<State> layer = {State::make(level.startBoxes, start)};
+  seen.insert(layer[0]);
+  std::vector<State> next;
+  for (int depth = 1; !layer.empty(); depth++) {
+    next.clear();
+    for (const State& s : layer) {
+      const Bits boxes = s.boxes();
+      flood(level, boxes, s.player(), reach);
+      for (int b = 0; b < CELLS; b++) {
+        if (!boxes.test(b)) {
+          continue;
+        }
+        for (int d = 0; d < DIR_COUNT; d++) {
+          int from = b - STEP[d];
+          int to = b + STEP[d];
+          if (!reach.test(from) || !canPushTo(level, boxes, to)) {
+            continue;
+          }
+          Bits moved = boxes;
+          moved.clear(b);
+          moved.set(to);
+          if (moved == level.goals) {
+            return depth;
+          }
+          Bits ignored;
+          State ns = State::make(moved, flood(level, moved, b, ignored));
+          if (seen.insert(ns)) {
+            next.push_back(ns);
+          }
+        }
+      }
+    }
+    if (seen.size() > maxStates) {
+      return -1;
+    }
+    layer.swap(next);
+  }
+  return -1;
+}
+
+void emitLevel(Level& level, size_t maxStates, int index) {
+  int moves = -1;
+  int pushes = -1;
+  if (parseLevel(level)) {
+    moves = solveMoves(level, maxStates);
+    pushes = solvePushes(level, maxStates);
+  }
+  fprintf(stderr, "level %d: moves %d pushes %d\n", index, moves, pushes);
+  printf("; par moves %d pushes %d\n", moves < 0 ? 0 : moves, pushes < 0 ? 0 : pushes);
+  for (std::string& row : level.rows) {
+    printf("%s\n", row.c_str());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <levels.xsb> [max-states]\n", argv[0]);
+    return 2;
+  }
+  size_t maxStates = (argc > 2) ? (size_t)strtoull(argv[2], nullptr, 10) : 50000000u;
+  FILE* f = fopen(argv[1], "r");
+  if (f == nullptr) {
+    fprintf(stderr, "cannot read %s\n", argv[1]);
+    return 1;
+  }
+
+  Level level;
+  int index = 0;
+  char buf[256];
+  while (fgets(buf, sizeof(buf), f) != nullptr) {
+    std::string line(buf);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (isBoardRow(line)) {
+      for (char& c : line) {
+        c = (c == '-' || c == '_') ? ' ' : c;
+      }
+      level.rows.push_back(line);
+      continue;
+    }
+    if (!level.rows.empty()) {
+      emitLevel(level, maxStates, ++index);
+      level = Level();
+    }
+    // Old par lines are replaced by the ones written above each level.
+    if (line.rfind("; par ", 0) != 0) {
+      printf("%s\n", line.c_str());
+    }
+  }
+  if (!level.rows.empty()) {
+    emitLevel(level, maxStates, ++index);
+  }
+  fclose(f);
+  return 0;
+}
@@ -0,0 +1,66 @@
+// Inspect or modify a progress image (an EEPROM dump or a host stand-in file).
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. -Itools -o progress_tool tools/progress_tool.cpp ProgressStore.cpp
+//     SokobanLevels.cpp LevelPack.cpp
+// Usage:
+//   ./progress_tool <image> dump
+//   ./progress_tool <image> solve <level> <moves> <pushes>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "FileProgressStorage.h"
+#include "ProgressStore.h"
+
+namespace {
+
+constexpr uint32_t IMAGE_SIZE = 1024;
+
+void dump(const ProgressStore& store) {
+  const ProgressData& data = store.data();
+  printf("sequence %lu (%d slots)\n", (unsigned long)store.sequence(), store.slotCount());
+  printf("unlocked %u, last level %u\n",
+         (unsigned)data.unlockedLevels, (unsigned)data.lastLevel + 1);
+  for (int i = 0; i < SokobanLevels::LEVEL_COUNT; i++) {
+    if (data.bestMoves[i] == 0) {
+      printf("  level %2d  -\n", i + 1);
+    } else {
+      printf("  level %2d  moves %5u  pushes %5u\n",
+             i + 1, (unsigned)data.bestMoves[i], (unsigned)data.bestPushes[i]);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <image> dump | solve <level> <moves> <pushes>\n", argv[0]);
+    return 2;
+  }
+
+  FileProgressStorage storage(argv[1], IMAGE_SIZE);
+  ProgressStore store(storage);
+  store.begin();
+
+  if (strcmp(argv[2], "solve") == 0 && argc >= 6) {
+    int level = atoi(argv[3]) - 1;
+    if (level < 0 || level >= SokobanLevels::LEVEL_COUNT) {
+      fprintf(stderr, "level out of range\n");
+      return 2;
+    }
+    store.recordLevelSolved((uint8_t)level, (uint32_t)atol(argv[4]), (uint32_t)atol(argv[5]));
+    if (!store.flush()) {
+      fprintf(stderr, "flush failed\n");
+      return 1;
+    }
+  } else if (strcmp(argv[2], "dump") != 0) {
+    fprintf(stderr, "unknown command %s\n", argv[2]);
+    return 2;
+  }
+
+  dump(store);
+  return 0;
+}
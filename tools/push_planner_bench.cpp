@@ -0,0 +1,109 @@
+// Host benchmark for PushPlanner over every box/destination pair of the built-in levels.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=c++17 -I. -o push_planner_bench tools/push_planner_bench.cpp
+//     PushPlanner.cpp PathFinder.cpp SokobanLevels.cpp LevelPack.cpp
+//   ./push_planner_bench [esp32-slowdown]
+//
+// The worst plan time is scaled by an assumed slowdown factor (default 50 for a 240 MHz
+// ESP32) and compared with the game's 10 ms frame step. That is an estimate, not a device
+// measurement: a build with -DSOKOBAN_RENDER_STATS=1 logs the real time of every plan on the
+// board as "[plan] pushes=<n> in <us> us".
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "PushPlanner.h"
+#include "SokobanLevels.h"
+#include "SokobanRules.h"
+
+namespace {
+
+constexpr double FRAME_BUDGET_US = 10000.0;
+constexpr int REPEATS = 5;
+
+struct LoadedLevel {
+  SokobanRules::Board board;
+  int w = 0;
+  int h = 0;
+  int playerX = 0;
+  int playerY = 0;
+};
+
+LoadedLevel loadLevel(uint8_t index) {
+  LoadedLevel level;
+  SokobanLevels::load(index, level.board, level.w, level.h);
+  for (int y = 0; y < level.h; y++) {
+    for (int x = 0; x < level.w; x++) {
+      char cell = level.board[y][x];
+      if (cell == '@' || cell == '+') {
+        level.playerX = x;
+        level.playerY = y;
+      }
+    }
+  }
+  return level;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double slowdown = argc > 1 ? atof(argv[1]) : 50.0;
+  static PushPlanner planner;
+  double worstUs = 0.0;
+
+  printf("%-6s %6s %8s %10s %10s\n", "level", "plans", "solved", "mean_us", "max_us");
+  for (int i = 0; i < SokobanLevels::LEVEL_COUNT; i++) {
+    LoadedLevel level = loadLevel((uint8_t)i);
+    int plans = 0;
+    int solved = 0;
+    double totalUs = 0.0;
+    double maxUs = 0.0;
+    for (int by = 0; by < level.h; by++) {
+      for (int bx = 0; bx < level.w; bx++) {
+        if (!SokobanRules::isBox(level.board[by][bx])) {
+          continue;
+        }
+        for (int ty = 0; ty < level.h; ty++) {
+          for (int tx = 0; tx < level.w; tx++) {
+            if (!SokobanRules::isFreeForBox(level.board[ty][tx])) {
+              continue;
+            }
+            // Best of a few runs, so scheduler noise on the host does not count as plan cost.
+            int pushes = -1;
+            double us = 0.0;
+            for (int rep = 0; rep < REPEATS; rep++) {
+              auto start = std::chrono::steady_clock::now();
+              pushes = planner.plan(
+                level.board, level.w, level.h, level.playerX, level.playerY, bx, by, tx, ty);
+              auto end = std::chrono::steady_clock::now();
+              double runUs = std::chrono::duration<double, std::micro>(end - start).count();
+              if (rep == 0 || runUs < us) {
+                us = runUs;
+              }
+            }
+            plans++;
+            solved += pushes > 0 ? 1 : 0;
+            totalUs += us;
+            if (us > maxUs) {
+              maxUs = us;
+            }
+          }
+        }
+      }
+    }
+    if (maxUs > worstUs) {
+      worstUs = maxUs;
+    }
+    printf("%-6d %6d %8d %10.2f %10.2f\n",
+           i + 1, plans, solved, plans > 0 ? totalUs / plans : 0.0, maxUs);
+  }
+
+  double estimatedUs = worstUs * slowdown;
+  printf("worst host plan %.2f us, estimated ESP32 %.0f us (assumed x%.0f), frame budget "
+         "%.0f us: %s\n",
+         worstUs, estimatedUs, slowdown, FRAME_BUDGET_US,
+         estimatedUs <= FRAME_BUDGET_US ? "estimate fits" : "estimate OVER BUDGET");
+  return estimatedUs <= FRAME_BUDGET_US ? 0 : 1;
+}
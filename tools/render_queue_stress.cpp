@@ -0,0 +1,130 @@
+// Host check for RenderQueue with the render task on a std::thread, the same split the game
+// uses with SOKOBAN_DUAL_CORE on ESP32.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=c++17 -pthread -DSOKOBAN_DUAL_CORE=1 -I. -o render_queue_stress
+//     tools/render_queue_stress.cpp RenderTask.cpp
+//   ./render_queue_stress [frames] [flush-us-per-rect]
+//
+// The logic side changes random cells of a small "screen" and publishes a frame per step; the
+// render side copies the dirty rects of each frame it takes, sleeping to stand in for SPI.
+// At the end the drawn screen must match the logic state exactly, and the logic step time
+// must not grow with the simulated flush cost.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "RenderQueue.h"
+#include "RenderTask.h"
+
+namespace {
+
+constexpr int SCREEN_W = 32;
+constexpr int SCREEN_H = 24;
+
+struct View {
+  uint32_t cells[SCREEN_H][SCREEN_W];
+};
+
+using Queue = RenderQueue<View, 8>;
+
+struct Harness {
+  Queue queue;
+  View logic{};
+  uint32_t drawn[SCREEN_H][SCREEN_W]{};
+  int flushUsPerRect = 0;
+  std::atomic<uint32_t> framesDrawn{0};
+};
+
+void drawRect(Harness& h, const View& view, int x0, int y0, int x1, int y1) {
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      h.drawn[y][x] = view.cells[y][x];
+    }
+  }
+  if (h.flushUsPerRect > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(h.flushUsPerRect));
+  }
+}
+
+void renderMain(void* ctx) {
+  Harness& h = *static_cast<Harness*>(ctx);
+  for (;;) {
+    const Queue::Frame* frame = h.queue.acquire();
+    if (frame == nullptr) {
+      RenderTask::pause();
+      continue;
+    }
+    if (frame->rects.all()) {
+      drawRect(h, frame->view, 0, 0, SCREEN_W - 1, SCREEN_H - 1);
+    } else {
+      for (int i = 0; i < frame->rects.count(); i++) {
+        const auto& r = frame->rects.rect(i);
+        drawRect(h, frame->view, r.x0, r.y0, r.x1, r.y1);
+      }
+    }
+    h.queue.release(*frame);
+    h.framesDrawn.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int frames = (argc > 1) ? atoi(argv[1]) : 200000;
+  static Harness h;
+  h.flushUsPerRect = (argc > 2) ? atoi(argv[2]) : 20;
+
+  if (!RenderTask::start(renderMain, &h)) {
+    fprintf(stderr, "could not start the render task\n");
+    return 1;
+  }
+
+  uint32_t seed = 12345;
+  long long worstStepNs = 0;
+  long long totalStepNs = 0;
+  for (int frame = 1; frame <= frames; frame++) {
+    auto start = std::chrono::steady_clock::now();
+    int changes = 1 + frame % 3;
+    for (int i = 0; i < changes; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      int x = (int)((seed >> 8) % SCREEN_W);
+      int y = (int)((seed >> 20) % SCREEN_H);
+      h.logic.cells[y][x] = (uint32_t)frame;
+      h.queue.markDirty(x, y, x, y);
+    }
+    if (frame % 5000 == 0) {
+      h.queue.markAll();
+    }
+    h.queue.publish([](View& view) { view = h.logic; });
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+    totalStepNs += ns;
+    if (ns > worstStepNs) {
+      worstStepNs = ns;
+    }
+  }
+
+  while (!h.queue.drained()) {
+    RenderTask::pause();
+  }
+
+  int mismatches = 0;
+  for (int y = 0; y < SCREEN_H; y++) {
+    for (int x = 0; x < SCREEN_W; x++) {
+      if (h.drawn[y][x] != h.logic.cells[y][x]) {
+        mismatches++;
+      }
+    }
+  }
+
+  printf("frames published %d, drawn %u\n", frames, (unsigned)h.framesDrawn.load());
+  printf("logic step avg %.2f us, worst %.2f us (flush %d us/rect)\n",
+         (double)totalStepNs / frames / 1000.0, (double)worstStepNs / 1000.0, h.flushUsPerRect);
+  printf("%s: %d mismatched cells\n", mismatches == 0 ? "OK" : "FAIL", mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
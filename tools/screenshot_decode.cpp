@@ -0,0 +1,287 @@
+// Turn a SOKOBAN_SCREENSHOT stream into a PNG. The input is either a capture of the serial
+// output (any log text around the stream is skipped) or the serial device itself, in which
+// case the tool requests a screenshot and reads it back.
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. -o screenshot_decode tools/screenshot_decode.cpp
+// Usage:
+//   ./screenshot_decode <capture file | /dev/ttyACM0> <out.png>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Crc32.h"
+
+namespace {
+
+const char* const HEADER_TAG = "SOKOBAN-SHOT ";
+const char* const TRAILER_TAG = "\nEND ";
+constexpr size_t TRAILER_LEN = 5 + 8 + 1;
+constexpr int SERIAL_TIMEOUT_DS = 30;
+
+bool readFile(const char* path, std::vector<uint8_t>& data) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+    data.insert(data.end(), chunk, chunk + n);
+  }
+  fclose(f);
+  return true;
+}
+
+size_t find(const std::vector<uint8_t>& data, const char* tag, size_t from) {
+  size_t len = strlen(tag);
+  for (size_t i = from; i + len <= data.size(); i++) {
+    if (memcmp(&data[i], tag, len) == 0) {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
+bool readSerial(int fd, std::vector<uint8_t>& data) {
+  termios tio{};
+  if (tcgetattr(fd, &tio) != 0) {
+    return false;
+  }
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, B115200);
+  cfsetospeed(&tio, B115200);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = SERIAL_TIMEOUT_DS;
+  if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+    return false;
+  }
+  tcflush(fd, TCIOFLUSH);
+  if (write(fd, "S", 1) != 1) {
+    return false;
+  }
+
+  // Stop at the trailer, an error line, or when the board goes quiet.
+  uint8_t chunk[1024];
+  for (;;) {
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n <= 0) {
+      return true;
+    }
+    data.insert(data.end(), chunk, chunk + n);
+    size_t header = find(data, HEADER_TAG, 0);
+    if (header == std::string::npos) {
+      continue;
+    }
+    bool isError = find(data, "SOKOBAN-SHOT ERR", header) == header;
+    if (isError && find(data, "\n", header) != std::string::npos) {
+      return true;
+    }
+    size_t trailer = find(data, TRAILER_TAG, header);
+    if (trailer != std::string::npos && data.size() >= trailer + TRAILER_LEN) {
+      return true;
+    }
+  }
+}
+
+bool decode(const std::vector<uint8_t>& data, int& w, int& h, std::vector<uint16_t>& pixels) {
+  size_t pos = find(data, HEADER_TAG, 0);
+  if (pos == std::string::npos) {
+    fprintf(stderr, "no screenshot header found\n");
+    return false;
+  }
+  size_t eol = find(data, "\n", pos);
+  if (eol == std::string::npos) {
+    fprintf(stderr, "truncated header\n");
+    return false;
+  }
+  std::string header(data.begin() + (long)pos, data.begin() + (long)eol);
+  char format[16] = {};
+  if (sscanf(header.c_str(), "SOKOBAN-SHOT %d %d %15s", &w, &h, format) != 3 ||
+      strcmp(format, "RLE565") != 0 || w <= 0 || h <= 0) {
+    fprintf(stderr, "device reported: %s\n", header.c_str());
+    return false;
+  }
+
+  pixels.assign((size_t)w * h, 0);
+  size_t total = pixels.size();
+  size_t out = 0;
+  pos = eol + 1;
+  auto pixelAt = [&data](size_t at) {
+    return (uint16_t)(data[at] | (data[at + 1] << 8));
+  };
+  while (out < total) {
+    if (pos >= data.size()) {
+      fprintf(stderr, "stream ends after %zu of %zu pixels\n", out, total);
+      return false;
+    }
+    uint8_t op = data[pos++];
+    size_t count;
+    size_t rowEnd = (out / w + 1) * (size_t)w;
+    if (op & 0x80) {
+      count = (size_t)(op & 0x7F) + 1;
+      if (out < (size_t)w || out + count > rowEnd) {
+        fprintf(stderr, "bad copy-up packet at pixel %zu\n", out);
+        return false;
+      }
+      for (size_t i = 0; i < count; i++, out++) {
+        pixels[out] = pixels[out - w];
+      }
+    } else if (op & 0x40) {
+      count = (size_t)(op & 0x3F) + 1;
+      if (pos + 2 > data.size() || out + count > rowEnd) {
+        fprintf(stderr, "bad run packet at pixel %zu\n", out);
+        return false;
+      }
+      uint16_t pixel = pixelAt(pos);
+      pos += 2;
+      for (size_t i = 0; i < count; i++) {
+        pixels[out++] = pixel;
+      }
+    } else {
+      count = (size_t)op + 1;
+      if (pos + 2 * count > data.size() || out + count > rowEnd) {
+        fprintf(stderr, "bad literal packet at pixel %zu\n", out);
+        return false;
+      }
+      for (size_t i = 0; i < count; i++, pos += 2) {
+        pixels[out++] = pixelAt(pos);
+      }
+    }
+  }
+
+  if (find(data, TRAILER_TAG, pos) != pos || data.size() < pos + TRAILER_LEN) {
+    fprintf(stderr, "missing trailer\n");
+    return false;
+  }
+  std::string crcText(data.begin() + (long)pos + 5, data.begin() + (long)pos + 13);
+  uint32_t expected = (uint32_t)strtoul(crcText.c_str(), nullptr, 16);
+  uint32_t crc = 0;
+  for (uint16_t p : pixels) {
+    uint8_t raw[2] = {(uint8_t)(p & 0xFF), (uint8_t)(p >> 8)};
+    crc = crc32Update(crc, raw, sizeof(raw));
+  }
+  if (crc != expected) {
+    fprintf(stderr, "checksum mismatch: stream %08x, decoded %08x\n", expected, crc);
+    return false;
+  }
+  printf("%dx%d, %zu stream bytes (raw %zu)\n", w, h, pos - (eol + 1), total * 2);
+  return true;
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+  out.push_back((uint8_t)(v >> 24));
+  out.push_back((uint8_t)(v >> 16));
+  out.push_back((uint8_t)(v >> 8));
+  out.push_back((uint8_t)v);
+}
+
+void putChunk(FILE* f, const char* type, const std::vector<uint8_t>& body) {
+  std::vector<uint8_t> chunk;
+  putU32(chunk, (uint32_t)body.size());
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), body.begin(), body.end());
+  putU32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+  fwrite(chunk.data(), 1, chunk.size(), f);
+}
+
+// Uncompressed PNG: the image data is a zlib stream of stored deflate blocks, which keeps
+// the tool free of a zlib dependency. Screenshots are small enough not to care.
+bool writePng(const char* path, int w, int h, const std::vector<uint16_t>& pixels) {
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)h * (1 + 3 * w));
+  for (int y = 0; y < h; y++) {
+    raw.push_back(0);
+    for (int x = 0; x < w; x++) {
+      uint16_t p = pixels[(size_t)y * w + x];
+      uint8_t r = (uint8_t)((p >> 11) & 0x1F);
+      uint8_t g = (uint8_t)((p >> 5) & 0x3F);
+      uint8_t b = (uint8_t)(p & 0x1F);
+      raw.push_back((uint8_t)((r << 3) | (r >> 2)));
+      raw.push_back((uint8_t)((g << 2) | (g >> 4)));
+      raw.push_back((uint8_t)((b << 3) | (b >> 2)));
+    }
+  }
+
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  uint32_t adlerA = 1;
+  uint32_t adlerB = 0;
+  for (uint8_t byte : raw) {
+    adlerA = (adlerA + byte) % 65521u;
+    adlerB = (adlerB + adlerA) % 65521u;
+  }
+  size_t at = 0;
+  do {
+    size_t len = raw.size() - at < 65535 ? raw.size() - at : 65535;
+    zlib.push_back(at + len == raw.size() ? 1 : 0);
+    zlib.push_back((uint8_t)len);
+    zlib.push_back((uint8_t)(len >> 8));
+    zlib.push_back((uint8_t)~len);
+    zlib.push_back((uint8_t)(~len >> 8));
+    zlib.insert(zlib.end(), raw.begin() + (long)at, raw.begin() + (long)(at + len));
+    at += len;
+  } while (at < raw.size());
+  putU32(zlib, (adlerB << 16) | adlerA);
+
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  fwrite(SIGNATURE, 1, sizeof(SIGNATURE), f);
+  std::vector<uint8_t> ihdr;
+  putU32(ihdr, (uint32_t)w);
+  putU32(ihdr, (uint32_t)h);
+  ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});
+  putChunk(f, "IHDR", ihdr);
+  putChunk(f, "IDAT", zlib);
+  putChunk(f, "IEND", {});
+  return fclose(f) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <capture file | serial device> <out.png>\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> data;
+  int fd = open(argv[1], O_RDWR | O_NOCTTY);
+  if (fd >= 0 && isatty(fd)) {
+    bool ok = readSerial(fd, data);
+    close(fd);
+    if (!ok) {
+      fprintf(stderr, "cannot configure %s\n", argv[1]);
+      return 1;
+    }
+  } else {
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (!readFile(argv[1], data)) {
+      fprintf(stderr, "cannot read %s\n", argv[1]);
+      return 1;
+    }
+  }
+
+  int w = 0;
+  int h = 0;
+  std::vector<uint16_t> pixels;
+  if (!decode(data, w, h, pixels)) {
+    return 1;
+  }
+  if (!writePng(argv[2], w, h, pixels)) {
+    fprintf(stderr, "cannot write %s\n", argv[2]);
+    return 1;
+  }
+  return 0;
+}
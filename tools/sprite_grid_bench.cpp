@@ -0,0 +1,165 @@
+// Host benchmark for SpriteGrid against a scan of every sprite slot per region, which is what
+// a flat sprite layer does for each flushed tile.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=c++17 -I. -o sprite_grid_bench tools/sprite_grid_bench.cpp SpriteGrid.cpp
+//   ./sprite_grid_bench [rounds]
+//
+// The scene is a box-heavy 14x10 board at 16 px cells on a 320x240 panel: 23 boxes and the
+// player, every sprite slot in use. Regions are the 64x64 tiles of a full-screen flush and
+// the single cells a move dirties. Both paths must produce identical pixels.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "SpriteGrid.h"
+
+namespace {
+
+constexpr int SCREEN_W = 320;
+constexpr int SCREEN_H = 240;
+constexpr int CELL = 16;
+constexpr int BOARD_W = SokobanRules::BOARD_MAX_W;
+constexpr int BOARD_H = SokobanRules::BOARD_MAX_H;
+constexpr int ORIGIN_X = (SCREEN_W - BOARD_W * CELL) / 2;
+constexpr int ORIGIN_Y = 48 + (SCREEN_H - 52 - BOARD_H * CELL) / 2;
+constexpr int TILE = 64;
+
+struct Slot {
+  int x;
+  int y;
+  const uint8_t* pixels;
+};
+
+// Palette indices, resolved through `palette` as the game does.
+uint8_t boxArt[CELL * CELL];
+uint8_t playerArt[CELL * CELL];
+uint16_t palette[256];
+Slot slots[SpriteGrid::MAX_SPRITES];
+uint16_t bufScan[TILE * TILE];
+uint16_t bufGrid[TILE * TILE];
+
+// The flat layer: every slot is clipped against the region, hit or not.
+void renderScan(int x0, int y0, int w, int h, uint16_t* buf) {
+  for (const Slot& s : slots) {
+    const int xs = (s.x > x0) ? s.x : x0;
+    const int xe = (s.x + CELL < x0 + w) ? s.x + CELL : x0 + w;
+    const int ys = (s.y > y0) ? s.y : y0;
+    const int ye = (s.y + CELL < y0 + h) ? s.y + CELL : y0 + h;
+    for (int y = ys; y < ye; y++) {
+      const uint8_t* src = s.pixels + (y - s.y) * CELL + (xs - s.x);
+      uint16_t* dst = buf + (y - y0) * w + (xs - x0);
+      for (int x = xs; x < xe; x++, src++, dst++) {
+        if (*src != 0) {
+          *dst = palette[*src];
+        }
+      }
+    }
+  }
+}
+
+struct Region {
+  int x;
+  int y;
+  int w;
+  int h;
+};
+
+int countMismatches(const SpriteGrid& grid, const Region* regions, int count) {
+  int mismatches = 0;
+  for (int i = 0; i < count; i++) {
+    const Region& r = regions[i];
+    memset(bufScan, 0x11, sizeof(bufScan));
+    memset(bufGrid, 0x11, sizeof(bufGrid));
+    renderScan(r.x, r.y, r.w, r.h, bufScan);
+    grid.renderRegion(r.x, r.y, r.w, r.h, bufGrid);
+    mismatches += memcmp(bufScan, bufGrid, sizeof(bufScan)) != 0;
+  }
+  return mismatches;
+}
+
+template <class Render>
+double timeRegions(const Region* regions, int count, int rounds, uint16_t* buf, Render render) {
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < count; i++) {
+      render(regions[i].x, regions[i].y, regions[i].w, regions[i].h, buf);
+    }
+  }
+  double ns =
+    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  return ns / ((double)rounds * count);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int rounds = (argc > 1) ? atoi(argv[1]) : 20000;
+
+  for (int i = 0; i < CELL * CELL; i++) {
+    // A ring of transparent pixels, as the generated art has.
+    const int x = i % CELL;
+    const int y = i / CELL;
+    const bool edge = x == 0 || y == 0 || x == CELL - 1 || y == CELL - 1;
+    boxArt[i] = edge ? 0 : (uint8_t)(1 + i % 3);
+    playerArt[i] = edge ? 0 : (uint8_t)(4 + i % 3);
+  }
+  for (int i = 0; i < 256; i++) {
+    palette[i] = (uint16_t)(0x8000 | (i * 37));
+  }
+
+  SpriteGrid grid;
+  grid.setGeometry(ORIGIN_X, ORIGIN_Y, CELL);
+  grid.setPalette(palette);
+  uint32_t seed = 7;
+  bool used[BOARD_H][BOARD_W] = {};
+  for (int i = 0; i < SpriteGrid::MAX_SPRITES; i++) {
+    int gx = 0;
+    int gy = 0;
+    do {
+      seed = seed * 1664525u + 1013904223u;
+      gx = 1 + (int)((seed >> 8) % (BOARD_W - 2));
+      gy = 1 + (int)((seed >> 20) % (BOARD_H - 2));
+    } while (used[gy][gx]);
+    used[gy][gx] = true;
+    const uint8_t* art = (i == SpriteGrid::MAX_SPRITES - 1) ? playerArt : boxArt;
+    slots[i] = Slot{ORIGIN_X + gx * CELL, ORIGIN_Y + gy * CELL, art};
+    grid.setPosition(i, slots[i].x, slots[i].y, art);
+  }
+
+  Region tiles[(SCREEN_W / TILE) * (SCREEN_H / TILE + 1)];
+  int tileCount = 0;
+  for (int y = 0; y < SCREEN_H; y += TILE) {
+    for (int x = 0; x < SCREEN_W; x += TILE) {
+      tiles[tileCount++] = Region{x, y, TILE, (y + TILE <= SCREEN_H) ? TILE : SCREEN_H - y};
+    }
+  }
+  Region cells[BOARD_W * BOARD_H];
+  int cellCount = 0;
+  for (int gy = 0; gy < BOARD_H; gy++) {
+    for (int gx = 0; gx < BOARD_W; gx++) {
+      cells[cellCount++] = Region{ORIGIN_X + gx * CELL, ORIGIN_Y + gy * CELL, CELL, CELL};
+    }
+  }
+
+  const int mismatches =
+    countMismatches(grid, tiles, tileCount) + countMismatches(grid, cells, cellCount);
+
+  auto gridRender = [&grid](int x, int y, int w, int h, uint16_t* buf) {
+    grid.renderRegion(x, y, w, h, buf);
+  };
+  const double tileScan = timeRegions(tiles, tileCount, rounds, bufScan, renderScan);
+  const double tileGrid = timeRegions(tiles, tileCount, rounds, bufGrid, gridRender);
+  const double cellScan = timeRegions(cells, cellCount, rounds, bufScan, renderScan);
+  const double cellGrid = timeRegions(cells, cellCount, rounds, bufGrid, gridRender);
+
+  printf("%d sprites on a %dx%d board, %d px cells\n", SpriteGrid::MAX_SPRITES, BOARD_W,
+         BOARD_H, CELL);
+  printf("region           slot scan    grid      speedup\n");
+  printf("64x64 tile     %9.1f ns %9.1f ns  %5.2fx\n", tileScan, tileGrid, tileScan / tileGrid);
+  printf("16x16 cell     %9.1f ns %9.1f ns  %5.2fx\n", cellScan, cellGrid, cellScan / cellGrid);
+  printf("%s: %d regions differ\n", mismatches == 0 ? "OK" : "FAIL", mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Host check for rebuilding the sprite and target caches while the render task still has
+// frames queued, the situation a level with a different tile size creates under
+// SOKOBAN_DUAL_CORE: frames carry only pointers into the caches, so the logic side has to
+// wait for the render task before it rasterizes into them again.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=c++17 -pthread -DSOKOBAN_DUAL_CORE=1 -I. -o tile_switch_stress
+//     tools/tile_switch_stress.cpp RenderTask.cpp
+//   ./tile_switch_stress [frames] [frames-per-level] [--no-wait]
+//
+// Every frame stamps the cache generation it was captured at; the render side checks that
+// each cache byte it reads still carries that stamp. `--no-wait` skips the wait the game does
+// in `bindSpriteArt()` / `bindTargetRings()` and should report torn frames.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "RenderQueue.h"
+#include "RenderTask.h"
+
+namespace {
+
+constexpr int MAX_TILE = 20;
+constexpr int TILE_SIZES[] = {8, 12, 16, 20};
+
+struct View {
+  const uint8_t* spritePixels;
+  int tileSize;
+  uint8_t generation;
+};
+
+using Queue = RenderQueue<View, 8>;
+
+struct Harness {
+  Queue queue;
+  uint8_t spriteCache[MAX_TILE * MAX_TILE]{};
+  int tileSize = TILE_SIZES[0];
+  uint8_t generation = 1;
+  bool renderOwnsDisplay = false;
+  std::atomic<uint32_t> framesDrawn{0};
+  std::atomic<uint32_t> tornFrames{0};
+};
+
+void renderMain(void* ctx) {
+  Harness& h = *static_cast<Harness*>(ctx);
+  for (;;) {
+    const Queue::Frame* frame = h.queue.acquire();
+    if (frame == nullptr) {
+      RenderTask::pause();
+      continue;
+    }
+    const View& view = frame->view;
+    bool torn = false;
+    for (int i = 0; i < view.tileSize * view.tileSize; i++) {
+      // Reading the cache slowly stands in for the SPI flush of a sprite.
+      if (view.spritePixels[i] != view.generation) {
+        torn = true;
+      }
+      if (i % MAX_TILE == 0) {
+        std::this_thread::yield();
+      }
+    }
+    if (torn) {
+      h.tornFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    h.queue.release(*frame);
+    h.framesDrawn.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Same contract as `SokobanGame::waitForRenderIdle()`.
+void waitForRenderIdle(Harness& h) {
+  if (!h.renderOwnsDisplay) {
+    return;
+  }
+  while (!h.queue.drained()) {
+    RenderTask::pause();
+  }
+  h.renderOwnsDisplay = false;
+}
+
+void bindTile(Harness& h, int size, bool wait) {
+  if (size == h.tileSize) {
+    return;
+  }
+  if (wait) {
+    waitForRenderIdle(h);
+  }
+  h.generation = (uint8_t)(h.generation % 250 + 1);
+  for (int i = 0; i < size * size; i++) {
+    h.spriteCache[i] = h.generation;
+  }
+  h.tileSize = size;
+}
+
+void publishFrame(Harness& h) {
+  if (!h.renderOwnsDisplay) {
+    h.renderOwnsDisplay = true;
+    h.queue.markAll();
+  }
+  h.queue.publish([&h](View& view) {
+    view.spritePixels = h.spriteCache;
+    view.tileSize = h.tileSize;
+    view.generation = h.generation;
+  });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int frames = (argc > 1) ? atoi(argv[1]) : 200000;
+  const int framesPerLevel = (argc > 2) ? atoi(argv[2]) : 7;
+  const bool wait = !(argc > 3 && strcmp(argv[3], "--no-wait") == 0);
+  static Harness h;
+  memset(h.spriteCache, h.generation, sizeof(h.spriteCache));
+
+  if (!RenderTask::start(renderMain, &h)) {
+    fprintf(stderr, "could not start the render task\n");
+    return 1;
+  }
+
+  const int sizeCount = (int)(sizeof(TILE_SIZES) / sizeof(TILE_SIZES[0]));
+  int level = 0;
+  int switches = 0;
+  for (int frame = 1; frame <= frames; frame++) {
+    if (framesPerLevel > 0 && frame % framesPerLevel == 0) {
+      level++;
+      bindTile(h, TILE_SIZES[level % sizeCount], wait);
+      switches++;
+    }
+    h.queue.markDirty(0, 0, 0, 0);
+    publishFrame(h);
+    // The rest of a logic step, so the render task gets to take most frames.
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+  }
+  waitForRenderIdle(h);
+
+  const uint32_t torn = h.tornFrames.load();
+  printf("frames published %d, drawn %u, tile switches %d (%s)\n", frames,
+         (unsigned)h.framesDrawn.load(), switches, wait ? "waiting" : "not waiting");
+  printf("%s: %u torn frames\n", torn == 0 ? "OK" : "FAIL", (unsigned)torn);
+  return torn == 0 ? 0 : 1;
+}